@@ -9,6 +9,7 @@
 #ifndef DATA_HPP
 #define DATA_HPP
 
+#include "4T_WEIGHTS.hpp"
 #include "4T_header.h"
 
 class GST;
@@ -62,11 +63,6 @@ class DATA {
 											   LUTwr_E_R1[TUPLE_NUM * FEATURE_NUM + 1] = {0.0};
 	/// @}
 
-	/// @name Feature Mapping
-	/// @{
-	int trans[POS_NUM + 1] = {0};  ///< Translation table: Position encoding -> N-Tuple Index
-	/// @}
-
 	// =============================
 	// Core Methods
 	// =============================
@@ -86,6 +82,9 @@ class DATA {
 
 	/**
 	 * @brief Loads weight data from binary files.
+	 * * With LUT_MIRROR, each pattern's counters are pooled with its reflection's on load
+	 * * (fold_mirror_counts). Each row keeps half of the pair's counters, so files saved
+	 * * after a fold load back to the same counters and win rates.
 	 * @param num The iteration number/ID of the weight file to load.
 	 */
 	void read_data_file(int num);
@@ -14,9 +14,9 @@
 // ==========================================
 
 /**
- * @brief Initializes all Look-Up Tables (LUTs) and the N-Tuple translation table.
+ * @brief Initializes all Look-Up Tables (LUTs).
  * * Sets default weights to 1, visit counts to 2, and win rates to 0.5.
- * * Pre-computes the position-to-feature mapping (trans array).
+ * * The tuple geometry itself is the compile-time TUPLES table.
  */
 void DATA::init_data() {
 	for (int i = 0; i < TUPLE_NUM * FEATURE_NUM; i++) {
@@ -43,27 +43,6 @@ void DATA::init_data() {
 		LUTv_U_B1[i] = 2;
 		LUTwr_U_B1[i] = 0.5;
 	}
-
-	int loca_num = 0;
-	for (int i = 0; i < ROW * COL; i++) {  // 0~35
-		int loc;
-		// Encode all tuples on the board and store them in 'trans' for future lookup
-		if (i % 6 <= 2) {  // 1x4 Pattern
-			loca_num++;
-			loc = i * 36 * 36 * 36 + (i + 1) * 36 * 36 + (i + 2) * 36 + (i + 3);
-			trans[loc] = loca_num;
-		}
-		if (i < 18) {  // 4x1 Pattern
-			loca_num++;
-			loc = i * 36 * 36 * 36 + (i + 6) * 36 * 36 + (i + 12) * 36 + (i + 18);
-			trans[loc] = loca_num;
-		}
-		if (i % 6 <= 4 && i < 30) {	 // 2x2 Pattern
-			loca_num++;
-			loc = i * 36 * 36 * 36 + (i + 1) * 36 * 36 + (i + 6) * 36 + (i + 7);
-			trans[loc] = loca_num;
-		}
-	}
 }
 
 // ==========================================
@@ -139,6 +118,10 @@ void DATA::read_data_file(int num) {  // Reads data from CSV and writes to array
 			LUTwr_U[LUT_idx(std::stoll(a[0]), std::stoll(a[1]))] = std::stof(a[4]);
 		}
 	}
+#if LUT_MIRROR
+	fold_mirror_counts(LUTw_E, LUTv_E, LUTwr_E);
+	fold_mirror_counts(LUTw_U, LUTv_U, LUTwr_U);
+#endif
 }
 
 /**
@@ -230,6 +213,10 @@ void DATA::read_data_file_R1(int num) {
 			LUTwr_U_R1[LUT_idx(std::stoll(a[0]), std::stoll(a[1]))] = std::stof(a[4]);
 		}
 	}
+#if LUT_MIRROR
+	fold_mirror_counts(LUTw_E_R1, LUTv_E_R1, LUTwr_E_R1);
+	fold_mirror_counts(LUTw_U_R1, LUTv_U_R1, LUTwr_U_R1);
+#endif
 }
 
 /**
@@ -317,6 +304,10 @@ void DATA::read_data_file_B1(int num) {
 			LUTwr_U_B1[LUT_idx(std::stoll(a[0]), std::stoll(a[1]))] = std::stof(a[4]);
 		}
 	}
+#if LUT_MIRROR
+	fold_mirror_counts(LUTw_E_B1, LUTv_E_B1, LUTwr_E_B1);
+	fold_mirror_counts(LUTw_U_B1, LUTv_U_B1, LUTwr_U_B1);
+#endif
 }
 
 /**
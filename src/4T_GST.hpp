@@ -12,7 +12,18 @@
 
 #include "4T_header.h"
 
-class DATA;
+class InferenceWeights;
+class QuantizedWeights;
+
+// GST_BACKEND selects how gen_all_move finds the legal moves; the rules, history encoding and
+// evaluation are shared, so both backends produce the same move sets (in different orders).
+// GST_BITBOARD -> per-side occupancy bitboards, moves found by four shifts (Default)
+// GST_ARRAY    -> scans the four neighbours of every piece in board[]
+#define GST_ARRAY 0
+#define GST_BITBOARD 1
+#ifndef GST_BACKEND
+#define GST_BACKEND GST_BITBOARD
+#endif
 
 /// @brief Global constant for UCB exploration (Standard value: sqrt(2) approx 1.414)
 constexpr double EXPLORATION_PARAM = 1.414;
@@ -33,30 +44,105 @@ class GST {
 	friend class MCTS;
 	friend int main();
 
+   public:
+	/// Undo depth: is_over() declares a draw at 200 plies, the rest is headroom for probes
+	static constexpr int MAX_HISTORY = 256;
+
    private:
+	// The board, piece tables and game status come first and fit in two cache lines;
+	// a whole GST is ~0.8 KB, so determinization copies stay cheap.
+
 	/// @name Board Representation
 	/// @{
-	int board[ROW * COL];  ///< Grid status (0:Empty, 1:Red, 2:Blue, -1:Enemy Red, -2:Enemy Blue)
-	int piece_board[ROW * COL];	 ///< Piece ID map (-1:None, 0~15:Piece ID)
-	int pos[PIECES * 2];		 ///< Position lookup (0~7:User, 8~15:Enemy)
-	int color[PIECES * 2];		 ///< Color lookup (1:Red, 2:Blue, -1:Enemy Red, -2:Enemy Blue)
-	int piece_nums[4];	///< Piece counts [0]:MyRed, [1]:MyBlue, [2]:EnemyRed, [3]:EnemyBlue
-	bool revealed[PIECES * 2] = {false};  ///< Fog of War: True if the piece is revealed
+	int8_t board[ROW * COL];  ///< Grid status (0:Empty, 1:Red, 2:Blue, -1:Enemy Red, -2:Enemy Blue)
+	int8_t piece_board[ROW * COL];	///< Piece ID map (-1:None, 0~15:Piece ID)
+	int8_t pos[PIECES * 2];			///< Position lookup (0~7:User, 8~15:Enemy)
+	int8_t color[PIECES * 2];		///< Color lookup (1:Red, 2:Blue, -1:Enemy Red, -2:Enemy Blue)
+	int8_t piece_nums[4];  ///< Piece counts [0]:MyRed, [1]:MyBlue, [2]:EnemyRed, [3]:EnemyBlue
+#if GST_BACKEND == GST_BITBOARD
+	uint64_t occupied[2];  ///< Squares (bit 0~35) holding [0]: USER, [1]: ENEMY pieces
+#endif
 	/// @}
 
 	/// @name Game Status
 	/// @{
-	int nowTurn;			 ///< Current turn (USER / ENEMY)
-	int winner;				 ///< Game Result (USER / ENEMY / -1:None)
+	int8_t nowTurn;			 ///< Current turn (USER / ENEMY)
+	int8_t winner;			 ///< Game Result (USER / ENEMY / -1:None / -2:Draw)
 	bool is_escape = false;	 ///< Flag for "Escape" victory condition
+	int16_t n_plies;		 ///< Total plies (half-moves) played
+	bool revealed[PIECES * 2] = {false};  ///< Fog of War: True if the piece is revealed
 	/// @}
 
 	/// @name History & Tracking
 	/// @{
-	int history[1000];	///< Move history stack for Undo
-	int n_plies;		///< Total plies (half-moves) played
-	int step;			///< Current step counter (for internal tracking)
-						/// @}
+	int step;						///< Current step counter (for internal tracking)
+	uint16_t history[MAX_HISTORY];	///< Move history stack for Undo (encoding as in do_move)
+									/// @}
+
+	/// @name Incremental 4-Tuple Features
+	/// @{
+	/// Feature index (0~255) of every tuple, [0]: USER perspective, [1]: ENEMY perspective.
+	/// Tuples are numbered as in TUPLES (4T_WEIGHTS.hpp), squares read in lut_square order;
+	/// kept in sync with board[] by do_move/undo.
+	uint8_t tuple_feature[2][TUPLE_NUM];
+	/// @}
+
+	/// @name Side-to-Move Kernels
+	/// Specialized for Side = USER / ENEMY in 4T_GST_impl.cpp, so own/opponent signs, exit
+	/// squares, feature perspective and piece ranges are constants; the public functions of
+	/// the same name dispatch on nowTurn once per call.
+	/// @{
+	template <int Side>
+	int gen_move_as(int* move_arr, int piece, int location, int& count);
+	template <int Side>
+	int gen_all_move_as(int* move_arr);
+	template <int Side>
+	int gen_all_move_scan_as(int* move_arr);
+	template <int Side>
+	void do_move_as(int move);
+	template <int Side>
+	int lut_table_as() const;
+	template <int Side>
+	float compute_board_weight_as(const InferenceWeights& d);
+	template <int Side>
+	float compute_board_weight_as(const QuantizedWeights& d);
+
+	/**
+	 * @brief LUT index (TUPLES.lut_offset[t] + feature) of every tuple after each candidate.
+	 * * rows has TUPLE_NUM rows of MAX_MOVES columns; padding columns repeat the current board.
+	 */
+	template <int Side>
+	void candidate_rows_as(const int* moves, int n, int32_t (*rows)[MAX_MOVES]);
+	template <int Side>
+	void evaluate_moves_as(const InferenceWeights& d, const int* moves, int n, float* out);
+	template <int Side>
+	void evaluate_moves_as(const QuantizedWeights& d, const int* moves, int n, float* out);
+
+	/// Shared bodies of the float / quantized overloads below
+	template <int Side, class Weights>
+	void score_moves_as(const Weights& d, const int* moves, int n, float* weight);
+	template <int Side, class Weights>
+	int highest_weight_as(const Weights& d, pcg32& gen);
+	/// @}
+
+	/// Shared body of the float / quantized evaluate_move overloads
+	template <class Weights>
+	float evaluate_move_as(const Weights& d, int move);
+
+	/**
+	 * @brief Picks one candidate from its scores with SELECTION_MODE (ties and samples from 'gen').
+	 */
+	int select_move(const float* weight, int n, pcg32& gen);
+
+	/**
+	 * @brief undo() without the feature update; reports the two rewritten squares instead.
+	 */
+	void undo_board(int* sq, int* old_value);
+
+	/**
+	 * @brief Recomputes the occupancy bitboards from pos[] (bitboard backend; no-op otherwise).
+	 */
+	void rebuild_occupancy();
 
    public:
 	/// @name Core Game Logic
@@ -78,6 +164,18 @@ class GST {
 	 */
 	int gen_all_move(int* move_arr);
 
+	/**
+	 * @brief gen_all_move with a given backend: the same move set, in that backend's order.
+	 * * Lets perft compare the backends within one build (see has_backend).
+	 */
+	int gen_all_move_with(int backend, int* move_arr);
+
+	/**
+	 * @brief True for the backends gen_all_move_with accepts: GST_ARRAY always, and GST_BACKEND
+	 * * (the bitboards are only maintained when they are the build's backend).
+	 */
+	static bool has_backend(int backend) { return backend == GST_ARRAY || backend == GST_BACKEND; }
+
 	/**
 	 * @brief Helper: Generates moves for a specific piece.
 	 */
@@ -91,9 +189,22 @@ class GST {
 
 	/**
 	 * @brief Reverts the last move (Restores state from history).
+	 * * Exact inverse of do_move: board, piece counts, revealed flags and features all
+	 * * return to their previous values, so a search can rewind instead of copying.
 	 */
 	void undo();
 
+	/**
+	 * @brief Rewinds to 'plies' (<= n_plies); equivalent to undo() until n_plies == plies.
+	 */
+	void undo_to(int plies);
+
+	/**
+	 * @brief Empties the move history (n_plies = 0), e.g. when a long-lived GST starts a
+	 * * new game: set_board keeps the history, and do_move stops at MAX_HISTORY plies.
+	 */
+	void clear_history();
+
 	/**
 	 * @brief Checks if the game has ended.
 	 * @return true if there is a winner or draw condition met.
@@ -108,26 +219,71 @@ class GST {
 
 	/// @name 4-Tuple Heuristics (Feature Engineering)
 	/// @{
-	bool is_valid_pattern(int base_pos, const int* offset);	 ///< Checks if pattern is within bounds
-	int get_loc(int base_pos, const int* offset);			 ///< Gets encoded location of a pattern
-	int get_feature_unknown(int base_pos, const int* offset,
-							const int* feature_cache);	///< Extracts feature index
+	/**
+	 * @brief Computes the heuristic score for the entire board.
+	 * * Sums the LUT entries of the incrementally maintained tuple features
+	 * * (see INCREMENTAL_EVAL); the result is identical to compute_board_weight_full().
+	 * @return float Aggregated score from N-Tuple network.
+	 */
+	float compute_board_weight(const InferenceWeights&);
 
 	/**
-	 * @brief Retrieves the trained weight for a specific pattern.
+	 * @brief Same evaluation on quantized tables: sums the 61 codes as integers (SIMD when
+	 * * available) and dequantizes once.
 	 */
-	float get_weight(int base_pos, const int* offset, DATA& d, const int* feature_cache);
+	float compute_board_weight(const QuantizedWeights&);
 
 	/**
-	 * @brief Computes the heuristic score for the entire board.
-	 * @return float Aggregated score from N-Tuple network.
+	 * @brief The WeightTable the side to move is evaluated with (R1 / B1 endgame tables).
+	 */
+	int lut_table() const;
+
+	/**
+	 * @brief Reference evaluation: extracts every tuple feature from board[] from scratch.
+	 */
+	float compute_board_weight_full(const InferenceWeights&);
+
+	/**
+	 * @brief Recomputes tuple_feature from board[] (after bulk board setup).
+	 */
+	void rebuild_features();
+
+	/**
+	 * @brief Updates the tuples covering 'sq' after board[sq] changed from old_value.
+	 */
+	void update_features(int sq, int old_value);
+
+	/**
+	 * @brief Scores all candidate moves in one batch (see BATCH_EVAL).
+	 * * out[m] equals evaluate_move(moves[m]) bit for bit, without touching the board.
+	 */
+	void evaluate_moves(const InferenceWeights&, const int* moves, int n, float* out);
+	void evaluate_moves(const QuantizedWeights&, const int* moves, int n, float* out);
+
+	/**
+	 * @brief Scores one candidate move with do_move / compute_board_weight / undo.
+	 */
+	float evaluate_move(const InferenceWeights&, int move);
+	float evaluate_move(const QuantizedWeights&, int move);
+
+	/**
+	 * @brief The scores highest_weight samples from (evaluation plus corner/endgame bonuses).
 	 */
-	float compute_board_weight(DATA&);
+	void score_moves(const InferenceWeights&, const int* moves, int n, float* weight);
+	void score_moves(const QuantizedWeights&, const int* moves, int n, float* weight);
 
 	/**
 	 * @brief Greedy Policy: Selects the move with the highest heuristic weight.
+	 * @param policy RNG for tie-breaks and sampling (nullptr = the calling thread's policy RNG).
+	 */
+	int highest_weight(const InferenceWeights&, pcg32* policy = nullptr);
+	int highest_weight(const QuantizedWeights&, pcg32* policy = nullptr);
+
+	/**
+	 * @brief Reseeds the calling thread's policy RNG (highest_weight's sampling and tie-breaks).
+	 * * Each thread starts from std::random_device; search workers reseed from the search RNG.
 	 */
-	int highest_weight(DATA&);
+	static void seed_policy(uint64_t seed);
 	/// @}
 
 	/// @name Accessors & Helpers
@@ -140,7 +296,7 @@ class GST {
 	int get_nplies() { return this->n_plies; }
 
 	// Direct access for MCTS (Oracle/Cheating mode)
-	const int* get_full_colors() const { return color; }
+	const int8_t* get_full_colors() const { return color; }
 
 	// Direct access for ISMCTS (Fog of War handling)
 	const bool* get_revealed() const { return revealed; }
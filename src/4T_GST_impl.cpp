@@ -6,8 +6,8 @@
  * @author Chen You-Kai (Optimization & Docs)
  */
 
-#include "4T_DATA.hpp"
 #include "4T_GST.hpp"
+#include "4T_WEIGHTS.hpp"
 #include "4T_header.h"
 
 // ==========================================
@@ -37,15 +37,43 @@
 #pragma message("Compiling with argmax selection")
 #endif
 
+// INCREMENTAL_EVAL = 1 -> do_move/undo maintain tuple features; evaluation only sums LUTs (Default)
+// INCREMENTAL_EVAL = 0 -> compute_board_weight re-extracts every feature from board[]
+// EVAL_CROSSCHECK        -> (debug) compare both paths on every evaluation, abort on mismatch
+#ifndef INCREMENTAL_EVAL
+#define INCREMENTAL_EVAL 1
+#endif
+
+// BATCH_EVAL = 1 -> highest_weight scores all candidates in one batch, AVX2 gathers when the
+//                   CPU supports them, portable loop otherwise (Default)
+// BATCH_EVAL = 2 -> batched scoring, portable loops only (also for quantized single boards)
+// BATCH_EVAL = 0 -> do_move / compute_board_weight / undo for every candidate
+// Batching derives the candidates' features from tuple_feature, so it needs INCREMENTAL_EVAL.
+#ifndef BATCH_EVAL
+#define BATCH_EVAL 1
+#endif
+
+#if BATCH_EVAL != 2 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EVAL_AVX2 1
+#include <immintrin.h>
+#else
+#define EVAL_AVX2 0
+#endif
+
+#if !INCREMENTAL_EVAL
+#undef BATCH_EVAL
+#define BATCH_EVAL 0
+#endif
+
 // ==========================================
 // Random Number Generator
 // ==========================================
 // Thread-local PCG32 RNG: Seeded once, reused throughout the thread's life
 static thread_local pcg32 rng(std::random_device{}());
 
-// Helper lambda: Generates double u in [0, 1)
-auto next_u01 = []() {
-	return static_cast<double>(rng()) / (static_cast<double>(pcg32::max()) + 1.0);
+// Helper lambda: Generates double u in [0, 1) from 'gen'
+auto next_u01 = [](pcg32& gen) {
+	return static_cast<double>(gen()) / (static_cast<double>(pcg32::max()) + 1.0);
 };
 
 // ==========================================
@@ -73,10 +101,37 @@ static const int init_pos[2][PIECES] = {
 // Direction Offsets: {N, W, E, S}
 static const int dir_val[4] = {-COL, -1, 1, COL};
 
-// N-Tuple Pattern Offsets
-static const int offset_1x4[4] = {0, 1, 2, 3};	  // Horizontal 1x4
-static const int offset_2x2[4] = {0, 1, 6, 7};	  // Square 2x2
-static const int offset_4x1[4] = {0, 6, 12, 18};  // Vertical 4x1
+/**
+ * @brief Inverse of the TUPLES table: the tuples that contain each square.
+ * * For each square, lists the tuples covering it and the base-4 digit weight of that
+ * * square inside the tuple's feature index (64, 16, 4, 1).
+ */
+struct TupleCover {
+	struct Entry {
+		uint8_t tuple;	 ///< Tuple number (LUT row)
+		uint8_t weight;	 ///< Multiplier of this square's feature in the index
+	};
+	Entry cover[ROW * COL][12];	 ///< At most 4 tuples of each shape contain a square
+	int count[ROW * COL];
+
+	TupleCover() : count() {
+		for (int t = 0; t < TUPLE_NUM; t++) {
+			for (int k = 0; k < 4; k++) {
+				int sq = TUPLES.lut_square[t][k];
+				cover[sq][count[sq]++] = {static_cast<uint8_t>(t),
+										  static_cast<uint8_t>(1 << (2 * (3 - k)))};
+			}
+		}
+	}
+};
+static const TupleCover tuple_cover;
+
+/// Square feature from the USER / ENEMY point of view (empty 0, own red 1, own blue 2, other 3)
+static inline int feature_user(int v) { return v < 0 ? 3 : v; }
+static inline int feature_enemy(int v) { return v > 0 ? 3 : -v; }
+
+/// Board value of an unrevealed piece of the same side as 'color'
+static inline int unknown_of(int color) { return color < 0 ? -UNKNOWN : UNKNOWN; }
 
 // ==========================================
 // Terminal Utilities
@@ -172,6 +227,8 @@ void GST::set_board(char* position) {
 		}
 	}
 
+	rebuild_features();
+	rebuild_occupancy();
 	print_board();
 
 	return;
@@ -265,6 +322,8 @@ void GST::init_board() {
 	//     }
 	// }
 	step = 0;
+	rebuild_features();
+	rebuild_occupancy();
 
 	return;
 }
@@ -306,56 +365,127 @@ void GST::print_board() {
 }
 
 /**
- * @brief Generates moves for a specific piece.
+ * @brief Generates moves for a specific piece of side 'Side'.
+ * * A square is a target unless it holds one of Side's own pieces (sign * board > 0).
  */
-int GST::gen_move(int* move_arr, int piece, int location, int& count) {
+template <int Side>
+int GST::gen_move_as(int* move_arr, int piece, int location, int& count) {
+	constexpr int sign = Side == USER ? 1 : -1;	// Own pieces are positive for USER
+	constexpr int exit_w = Side == USER ? 0 : 30, exit_e = Side == USER ? 5 : 35;
 	int row = location / ROW;
 	int col = location % COL;
 
-	if (nowTurn == USER) {
-		// Normal moves: Up, Down, Left, Right
-		if (row != 0 && board[location - 6] <= 0) move_arr[count++] = piece << 4;			 // Up
-		if (row != ROW - 1 && board[location + 6] <= 0) move_arr[count++] = piece << 4 | 3;	 // Down
-		if (col != 0 && board[location - 1] <= 0) move_arr[count++] = piece << 4 | 1;		 // Left
-		if (col != COL - 1 && board[location + 1] <= 0)
-			move_arr[count++] = piece << 4 | 2;	 // Right
-
-		// Escape moves (Blue pieces only)
-		if (color[piece] == BLUE) {
-			if (location == 0) move_arr[count++] = piece << 4 | 1;	// Exit at Top-Left
-			if (location == 5) move_arr[count++] = piece << 4 | 2;	// Exit at Top-Right
-		}
-	} else {  // ENEMY Turn
-		if (row != 0 && board[location - 6] >= 0) move_arr[count++] = piece << 4;
-		if (row != ROW - 1 && board[location + 6] >= 0) move_arr[count++] = piece << 4 | 3;
-		if (col != 0 && board[location - 1] >= 0) move_arr[count++] = piece << 4 | 1;
-		if (col != COL - 1 && board[location + 1] >= 0) move_arr[count++] = piece << 4 | 2;
-
-		// Escape moves (Blue pieces only)
-		if (color[piece] == -BLUE) {
-			if (location == 30) move_arr[count++] = piece << 4 | 1;	 // Exit at Bottom-Left
-			if (location == 35) move_arr[count++] = piece << 4 | 2;	 // Exit at Bottom-Right
-		}
+	// Normal moves: Up, Down, Left, Right
+	if (row != 0 && sign * board[location - 6] <= 0) move_arr[count++] = piece << 4;  // Up
+	if (row != ROW - 1 && sign * board[location + 6] <= 0)
+		move_arr[count++] = piece << 4 | 3;	 // Down
+	if (col != 0 && sign * board[location - 1] <= 0) move_arr[count++] = piece << 4 | 1;  // Left
+	if (col != COL - 1 && sign * board[location + 1] <= 0)
+		move_arr[count++] = piece << 4 | 2;	 // Right
+
+	// Escape moves (Blue pieces only): top corners for USER, bottom corners for ENEMY
+	if (color[piece] == sign * BLUE) {
+		if (location == exit_w) move_arr[count++] = piece << 4 | 1;	// Exit to the left
+		if (location == exit_e) move_arr[count++] = piece << 4 | 2;	// Exit to the right
 	}
 	return count;
 }
 
 /**
- * @brief Generates all possible legal moves for the current player.
+ * @brief Generates moves for a specific piece.
  */
-int GST::gen_all_move(int* move_arr) {
-	int count = 0;
-	int offset = nowTurn == ENEMY ? PIECES : 0;
-	int* nowTurn_pos = pos + offset;
+int GST::gen_move(int* move_arr, int piece, int location, int& count) {
+	return nowTurn == USER ? gen_move_as<USER>(move_arr, piece, location, count)
+						   : gen_move_as<ENEMY>(move_arr, piece, location, count);
+}
 
-	for (int i = 0; i < PIECES; i++) {
-		if (pos[i + offset] != -1) {
-			gen_move(move_arr, i + offset, nowTurn_pos[i], count);
-		}
+/**
+ * @brief Generates all legal moves of side 'Side' piece by piece (the GST_ARRAY backend).
+ * * Built with either backend: it only reads board[], so it can check the bitboards.
+ */
+template <int Side>
+int GST::gen_all_move_scan_as(int* move_arr) {
+	constexpr int offset = Side == ENEMY ? PIECES : 0;
+	int count = 0;
+	for (int i = offset; i < offset + PIECES; i++) {
+		if (pos[i] != -1) gen_move_as<Side>(move_arr, i, pos[i], count);
 	}
+	return count;
+}
+
+#if GST_BACKEND == GST_BITBOARD
+/// Bitboard masks (bit = square 0~35): the whole board, and its first / last column
+static constexpr uint64_t BB_BOARD = (1ull << ROW * COL) - 1;
+static constexpr uint64_t BB_COL_W = 0x041041041ull;
+static constexpr uint64_t BB_COL_E = BB_COL_W << (COL - 1);
+
+/**
+ * @brief Generates all legal moves of side 'Side' with four shifts of its occupancy.
+ * * Direction-major (N, S, W, E, then exits): the same move set as the array backend,
+ * * in a different order.
+ */
+template <int Side>
+int GST::gen_all_move_as(int* move_arr) {
+	constexpr int sign = Side == USER ? 1 : -1;
+	constexpr int exit_w = Side == USER ? 0 : 30, exit_e = Side == USER ? 5 : 35;
+	const uint64_t own = occupied[Side];
+	const uint64_t target = ~own & BB_BOARD;
+	int count = 0;
 
+	// Each bit of m is a destination; the mover stands one step back against the direction
+	for (uint64_t m = own >> COL & target; m; m &= m - 1)
+		move_arr[count++] = piece_board[__builtin_ctzll(m) + COL] << 4;	 // Up
+	for (uint64_t m = own << COL & target; m; m &= m - 1)
+		move_arr[count++] = piece_board[__builtin_ctzll(m) - COL] << 4 | 3;	 // Down
+	for (uint64_t m = (own & ~BB_COL_W) >> 1 & target; m; m &= m - 1)
+		move_arr[count++] = piece_board[__builtin_ctzll(m) + 1] << 4 | 1;	 // Left
+	for (uint64_t m = (own & ~BB_COL_E) << 1 & target; m; m &= m - 1)
+		move_arr[count++] = piece_board[__builtin_ctzll(m) - 1] << 4 | 2;	 // Right
+
+	// Escape moves (Blue pieces only)
+	if (own >> exit_w & 1 && color[piece_board[exit_w]] == sign * BLUE)
+		move_arr[count++] = piece_board[exit_w] << 4 | 1;
+	if (own >> exit_e & 1 && color[piece_board[exit_e]] == sign * BLUE)
+		move_arr[count++] = piece_board[exit_e] << 4 | 2;
 	return count;
 }
+#else
+template <int Side>
+int GST::gen_all_move_as(int* move_arr) {
+	return gen_all_move_scan_as<Side>(move_arr);
+}
+#endif
+
+/**
+ * @brief Sets occupied[] from pos[] (after bulk board setup).
+ */
+void GST::rebuild_occupancy() {
+#if GST_BACKEND == GST_BITBOARD
+	occupied[USER] = occupied[ENEMY] = 0;
+	for (int i = 0; i < PIECES * 2; i++)
+		if (pos[i] != -1) occupied[i < PIECES ? USER : ENEMY] |= 1ull << pos[i];
+#endif
+}
+
+/**
+ * @brief Generates all possible legal moves for the current player.
+ */
+int GST::gen_all_move(int* move_arr) {
+	return nowTurn == USER ? gen_all_move_as<USER>(move_arr) : gen_all_move_as<ENEMY>(move_arr);
+}
+
+/**
+ * @brief Generates all legal moves with the given backend (see has_backend).
+ */
+int GST::gen_all_move_with(int backend, int* move_arr) {
+	if (backend == GST_BACKEND) return gen_all_move(move_arr);
+	if (backend != GST_ARRAY) {
+		fprintf(stderr, "gen_all_move_with: backend %d is not built in\n", backend);
+		exit(1);
+	}
+	return nowTurn == USER ? gen_all_move_scan_as<USER>(move_arr)
+						   : gen_all_move_scan_as<ENEMY>(move_arr);
+}
 
 /**
  * @brief Helper: Checks if a move results in an immediate win (Escape).
@@ -369,45 +499,58 @@ bool check_win_move(int location, int dir) {
 }
 
 /**
- * @brief Executes a move, updates board, handles captures, and checks state.
+ * @brief Executes a move of side 'Side', updates board, handles captures, and checks state.
+ * * A legal move can only capture an opponent piece, so the piece counts it may touch
+ * * (and the colors they are keyed on) are fixed by Side.
  */
-void GST::do_move(int move) {
+template <int Side>
+void GST::do_move_as(int move) {
+	constexpr int sign = Side == USER ? 1 : -1;		 // Own colors are sign * RED / BLUE
+	constexpr int opp_nums = Side == USER ? 2 : 0;	 // piece_nums index of the opponent's red
 	int piece = move >> 4;
 	int direction = move & 0xf;
 
+	// Safety break for infinite loops (before the escape, which also takes a ply)
+	if (n_plies >= MAX_HISTORY) {
+		fprintf(stderr, "cannot do anymore moves\n");
+		exit(1);
+	}
+
 	// Check for Escape Victory
-	if (abs(color[piece]) == BLUE) {
+	if (color[piece] == sign * BLUE) {
 		if (check_win_move(pos[piece], direction)) {
-			winner = nowTurn;
+			winner = Side;
 			n_plies++;
-			nowTurn ^= 1;
+			nowTurn = Side ^ 1;
 			is_escape = true;
 			return;
 		}
 	}
 
-	// Safety break for infinite loops
-	if (n_plies == MAX_PLIES) {
-		fprintf(stderr, "cannot do anymore moves\n");
-		exit(1);
-	}
-
 	// dst: the chess's location after move / pos: the location of chess / dir_val: up down left
 	// right
 	int dst = pos[piece] + dir_val[direction];
 
+	// Squares of unmoved hidden pieces may show UNKNOWN while color[] holds a
+	// determinized color; record that (and revealed[]) so undo restores them exactly
+	if (abs(board[pos[piece]]) == UNKNOWN) move |= 0x2000;
+	if (board[dst] != 0) {
+		if (abs(board[dst]) == UNKNOWN) move |= 0x4000;
+		if (!revealed[piece_board[dst]]) move |= 0x8000;
+	}
+
 	// Handle Captures
-	if (board[dst] < 0) {				// Occupied by Enemy
+	if (board[dst] != 0) {				// Occupied by the opponent
 		pos[piece_board[dst]] = -1;		// Piece eaten
 		move |= piece_board[dst] << 8;	// Record eaten piece in move (for undo)
 		revealed[piece_board[dst]] = true;
 
 		// Update piece counts
-		if (color[piece_board[dst]] == -RED)
-			piece_nums[2] -= 1;
-		else if (color[piece_board[dst]] == -BLUE)
-			piece_nums[3] -= 1;
-		else if (color[piece_board[dst]] == -UNKNOWN) {
+		if (color[piece_board[dst]] == -sign * RED)
+			piece_nums[opp_nums] -= 1;
+		else if (color[piece_board[dst]] == -sign * BLUE)
+			piece_nums[opp_nums + 1] -= 1;
+		else if (color[piece_board[dst]] == -sign * UNKNOWN) {
 			// Do nothing for unknown
 		} else {
 			fprintf(stderr, "piece: %d, direction: %d\n", piece, direction);
@@ -418,44 +561,45 @@ void GST::do_move(int move) {
 			fprintf(stderr, "do_move error, eaten color wrong!\n");
 			exit(1);
 		}
-	} else if (board[dst] > 0) {  // User's color
-		pos[piece_board[dst]] = -1;
-		move |= piece_board[dst] << 8;
-		revealed[piece_board[dst]] = true;
-		if (color[piece_board[dst]] == RED)
-			piece_nums[0] -= 1;
-		else if (color[piece_board[dst]] == BLUE)
-			piece_nums[1] -= 1;
-		else if (color[piece_board[dst]] == UNKNOWN) {
-			// Do nothing
-		} else {
-			fprintf(stderr, "piece: %d, direction: %d\n", piece, direction);
-			fprintf(stderr, "pos[piece]: %d, dir_val[direction]: %d\n", pos[piece],
-					dir_val[direction]);
-			fprintf(stderr, "color[piece_board[dst]]: %d, piece_board[dst]: %d\n",
-					color[piece_board[dst]], piece_board[dst]);
-			fprintf(stderr, "do_move error, eaten color wrong!\n");
-			exit(1);
-		}
 	} else {
 		// No capture, mark as empty move
 		move |= 0x1000;
 	}
 
 	// Update Board State
+	int src = pos[piece];
+	int old_src = board[src], old_dst = board[dst];
 	board[pos[piece]] = 0;		   // set 0 at the location which stay before => space: color = 0
 	piece_board[pos[piece]] = -1;  // set 0 at the location which stay before => space: no chess
 	board[dst] = color[piece];	   // color the chess color at the location after move
 	piece_board[dst] = piece;	   // set chess number at the location after move
 	pos[piece] = dst;			   // the location of chess now
+	update_features(src, old_src);
+	update_features(dst, old_dst);
+#if GST_BACKEND == GST_BITBOARD
+	occupied[Side] ^= 1ull << src | 1ull << dst;
+	occupied[Side ^ 1] &= ~(1ull << dst);
+#endif
 	history[n_plies++] = move;
-	nowTurn ^= 1;  // change player
+	nowTurn = Side ^ 1;	 // change player
 }
 
 /**
- * @brief Undoes the last move (restores board state).
+ * @brief Executes a move, updates board, handles captures, and checks state.
  */
-void GST::undo() {
+void GST::do_move(int move) {
+	if (nowTurn == USER)
+		do_move_as<USER>(move);
+	else
+		do_move_as<ENEMY>(move);
+}
+
+/**
+ * @brief Undoes the last move except for the tuple features.
+ * * Reports the two squares it rewrote and their previous values in sq / old_value
+ * * (-1 squares for an escape, which never touched the board).
+ */
+void GST::undo_board(int* sq, int* old_value) {
 	if (winner != -1) winner = -1;
 
 	if (n_plies == 0) {
@@ -465,7 +609,7 @@ void GST::undo() {
 	nowTurn ^= 1;  // Switch back to previous player
 
 	int move = history[--n_plies];
-	int check_eaten = move >> 12;
+	int check_eaten = move >> 12 & 0x1;
 	int eaten_piece = (move & 0xfff) >> 8;
 	int piece = (move & 0xff) >> 4;
 	int direction = move & 0xf;
@@ -473,14 +617,20 @@ void GST::undo() {
 
 	if (is_escape) {
 		is_escape = false;
+		sq[0] = sq[1] = -1;
 		return;
 	}
 
+	int dst = pos[piece];
+	sq[0] = src, old_value[0] = board[src];
+	sq[1] = dst, old_value[1] = board[dst];
+
 	// Restore captured piece if any
 	if (check_eaten != 0x1) {
-		board[pos[piece]] = color[eaten_piece];
+		board[pos[piece]] = (move & 0x4000) ? unknown_of(color[eaten_piece]) : color[eaten_piece];
 		piece_board[pos[piece]] = eaten_piece;
 		pos[eaten_piece] = pos[piece];
+		if (move & 0x8000) revealed[eaten_piece] = false;
 
 		// Restore piece counts
 		if (nowTurn == USER) {
@@ -513,9 +663,57 @@ void GST::undo() {
 	}
 
 	// Move piece back to src
-	board[src] = color[piece];
+	board[src] = (move & 0x2000) ? unknown_of(color[piece]) : color[piece];
 	piece_board[src] = piece;
 	pos[piece] = src;
+#if GST_BACKEND == GST_BITBOARD
+	occupied[nowTurn] ^= 1ull << src | 1ull << dst;
+	if (check_eaten != 0x1) occupied[nowTurn ^ 1] |= 1ull << dst;
+#endif
+}
+
+/**
+ * @brief Undoes the last move (restores board state).
+ */
+void GST::undo() {
+	int sq[2], old_value[2];
+	undo_board(sq, old_value);
+	if (sq[0] < 0) return;
+	update_features(sq[0], old_value[0]);
+	update_features(sq[1], old_value[1]);
+}
+
+/**
+ * @brief Undoes moves until n_plies == plies.
+ * * Same result as calling undo() repeatedly, but a square's features are shifted once,
+ * * from its value before the rewind to its final one, however often it changed.
+ */
+void GST::undo_to(int plies) {
+	uint64_t touched = 0;
+	int8_t before[ROW * COL];
+	while (n_plies > plies) {
+		int sq[2], old_value[2];
+		undo_board(sq, old_value);
+		if (sq[0] < 0) continue;
+		for (int k = 0; k < 2; k++) {
+			if (touched >> sq[k] & 1) continue;
+			touched |= 1ull << sq[k];
+			before[sq[k]] = old_value[k];
+		}
+	}
+	for (; touched; touched &= touched - 1) {
+		const int sq = __builtin_ctzll(touched);
+		update_features(sq, before[sq]);
+	}
+}
+
+/**
+ * @brief Forgets every recorded move; the board itself is left as it is.
+ */
+void GST::clear_history() {
+	memset(history, 0, sizeof(history));
+	n_plies = 0;
+	is_escape = false;
 }
 
 /**
@@ -546,84 +744,87 @@ bool GST::is_over() {
 // ==========================================
 
 /**
- * @brief Checks if a pattern is valid within board boundaries.
+ * @brief Recomputes every tuple's feature index (both perspectives) from board[].
  */
-bool GST::is_valid_pattern(int base_pos, const int* offset) {
-	int base_row = base_pos / COL;
-	int base_col = base_pos % COL;
-
-	if (offset == offset_1x4) {
-		if (base_col > 2) return false;
-	} else if (offset == offset_2x2) {
-		if (base_col > 4 || base_row > 4) return false;
-	} else if (offset == offset_4x1) {
-		if (base_row > 2) return false;
+void GST::rebuild_features() {
+	memset(tuple_feature, 0, sizeof(tuple_feature));
+	for (int sq = 0; sq < ROW * COL; sq++) {
+		for (int c = 0; c < tuple_cover.count[sq]; c++) {
+			const auto& e = tuple_cover.cover[sq][c];
+			tuple_feature[USER][e.tuple] += feature_user(board[sq]) * e.weight;
+			tuple_feature[ENEMY][e.tuple] += feature_enemy(board[sq]) * e.weight;
+		}
 	}
-
-	return true;
 }
 
 /**
- * @brief Encodes the location of a pattern.
+ * @brief Shifts the base-4 digit of 'sq' in each covering tuple (at most 12 tuples).
  */
-int GST::get_loc(int base_pos, const int* offset) {
-	int position[4];
-	for (int i = 0; i < 4; i++) {
-		position[i] = base_pos + offset[i];
+void GST::update_features(int sq, int old_value) {
+#if INCREMENTAL_EVAL
+	const int du = feature_user(board[sq]) - feature_user(old_value);
+	const int de = feature_enemy(board[sq]) - feature_enemy(old_value);
+	if (!du && !de) return;
+	for (int c = 0; c < tuple_cover.count[sq]; c++) {
+		const auto& e = tuple_cover.cover[sq][c];
+		tuple_feature[USER][e.tuple] += du * e.weight;
+		tuple_feature[ENEMY][e.tuple] += de * e.weight;
 	}
-	return (position[0] * 36 * 36 * 36 + position[1] * 36 * 36 + position[2] * 36 + position[3]);
+#endif
 }
 
 /**
- * @brief Extracts feature encoding from the board.
- * * Uses feature_cache for optimization.
+ * @brief Computes the aggregated weight of the entire board from Side's perspective.
+ * * The 61 lookups are summed one by one in tuple order, exactly like the full
+ * * recompute, so both paths return bit-identical floats. (A running float sum
+ * * updated by deltas would drift and could flip argmax ties in highest_weight.)
  */
-int GST::get_feature_unknown(int base_pos, const int* offset, const int* feature_cache) {
-	int features[4];
-	for (int i = 0; i < 4; i++) {
-		int pos = base_pos + offset[i];
+template <int Side>
+float GST::compute_board_weight_as(const InferenceWeights& d) {
+#if INCREMENTAL_EVAL
+	const float* lut = d.table(lut_table_as<Side>());
 
-		features[i] = feature_cache[pos];
+	const uint8_t* feature = tuple_feature[Side];
+	float total_weight = 0;
+	for (int t = 0; t < TUPLE_NUM; t++) total_weight += lut[TUPLES.lut_offset[t] + feature[t]];
+	total_weight /= (float)TUPLE_NUM;
+
+#ifdef EVAL_CROSSCHECK
+	const float reference = compute_board_weight_full(d);
+	if (total_weight != reference) {
+		fprintf(stderr, "compute_board_weight mismatch: incremental %.9g, full %.9g\n",
+				total_weight, reference);
+		exit(1);
 	}
-	return (features[0] * 64 + features[1] * 16 + features[2] * 4 + features[3]);
+#endif
+	return total_weight;
+#else
+	return compute_board_weight_full(d);
+#endif
+}
+
+float GST::compute_board_weight(const InferenceWeights& d) {
+	return nowTurn == USER ? compute_board_weight_as<USER>(d) : compute_board_weight_as<ENEMY>(d);
 }
 
 /**
- * @brief Retrieves heuristic weight for a specific pattern.
+ * @brief LUT selection based on remaining pieces.
  */
-float GST::get_weight(int base_pos, const int* offset, DATA& d, const int* feature_cache) {
-	// Pass feature_cache down to feature extraction
-	int feature = get_feature_unknown(base_pos, offset, feature_cache);
-
-	int LUTidx = d.LUT_idx(d.trans[get_loc(base_pos, offset)], feature);
-	float weight = 0;
-
-	// LUT selection based on remaining pieces
-	if (nowTurn == USER) {
-		if (piece_nums[2] == 1) {  // Enemy Red = 1
-			weight = d.LUTwr_U_R1[LUTidx];
-		} else if (piece_nums[1] == 1) {  // User Blue = 1
-			weight = d.LUTwr_U_B1[LUTidx];
-		} else {
-			weight = d.LUTwr_U[LUTidx];
-		}
-	} else {
-		if (piece_nums[0] == 1) {  // User Red = 1
-			weight = d.LUTwr_E_R1[LUTidx];
-		} else if (piece_nums[3] == 1) {  // Enemy Blue = 1
-			weight = d.LUTwr_E_B1[LUTidx];
-		} else {
-			weight = d.LUTwr_E[LUTidx];
-		}
-	}
+template <int Side>
+int GST::lut_table_as() const {
+	if (Side == USER)
+		return piece_nums[2] == 1 ? TABLE_U_R1 : piece_nums[1] == 1 ? TABLE_U_B1 : TABLE_U;
+	return piece_nums[0] == 1 ? TABLE_E_R1 : piece_nums[3] == 1 ? TABLE_E_B1 : TABLE_E;
+}
 
-	return weight;
+int GST::lut_table() const {
+	return nowTurn == USER ? lut_table_as<USER>() : lut_table_as<ENEMY>();
 }
 
 /**
- * @brief Computes the aggregated weight of the entire board.
+ * @brief Computes the aggregated weight of the entire board from scratch.
  */
-float GST::compute_board_weight(DATA& d) {
+float GST::compute_board_weight_full(const InferenceWeights& d) {
 	float total_weight = 0;
 
 	// 1. Create a fast L1 cache on stack
@@ -640,79 +841,330 @@ float GST::compute_board_weight(DATA& d) {
 		}
 	}
 
-	for (int pos = 0; pos < ROW * COL; pos++) {
-		if (is_valid_pattern(pos, offset_1x4)) {
-			total_weight += get_weight(pos, offset_1x4, d, feature_cache);
-		}
-		if (is_valid_pattern(pos, offset_4x1)) {
-			total_weight += get_weight(pos, offset_4x1, d, feature_cache);
+	// 3. LUT selection based on remaining pieces
+	const float* lut = d.table(lut_table());
+
+	// 4. Walk the tuple table in LUT row order
+	for (int t = 0; t < TUPLE_NUM; t++) {
+		const int* sq = TUPLES.lut_square[t];
+		const int feature = feature_cache[sq[0]] * 64 + feature_cache[sq[1]] * 16 +
+							feature_cache[sq[2]] * 4 + feature_cache[sq[3]];
+		total_weight += lut[TUPLES.lut_offset[t] + feature];
+	}
+
+	return total_weight / (float)TUPLE_NUM;
+}
+
+// ==========================================
+// Batched Candidate Scoring
+// ==========================================
+static_assert(MAX_MOVES % 8 == 0, "batched scoring processes candidates in groups of 8");
+
+/// LUT index (TUPLES.lut_offset[t] + feature) of every tuple, one column per candidate
+typedef int32_t TupleIndexBatch[TUPLE_NUM][MAX_MOVES];
+
+/**
+ * @brief Portable kernel: per candidate, sums the 61 LUT entries in tuple order.
+ */
+static void sum_tuple_weights_scalar(const float* lut, const TupleIndexBatch& idx, int n,
+									 float* out) {
+	for (int m = 0; m < n; m++) {
+		float total_weight = 0;
+		for (int t = 0; t < TUPLE_NUM; t++) total_weight += lut[idx[t][m]];
+		out[m] = total_weight / (float)TUPLE_NUM;
+	}
+}
+
+/**
+ * @brief Portable quantized kernel: per candidate, the integer sum of its 61 codes.
+ */
+static void sum_tuple_codes_scalar(const lut_quant_t* lut, const TupleIndexBatch& idx, int n,
+								   int32_t* out) {
+	for (int m = 0; m < n; m++) {
+		int32_t code_sum = 0;
+		for (int t = 0; t < TUPLE_NUM; t++) code_sum += lut[idx[t][m]];
+		out[m] = code_sum;
+	}
+}
+
+#if EVAL_AVX2
+static bool cpu_has_avx2() {
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	return has_avx2;
+}
+
+/**
+ * @brief AVX2 kernel: 8 candidates per register, one gather per tuple.
+ * * Every lane adds the same values in the same order as the scalar kernel, so the
+ * * results are bit-identical.
+ */
+__attribute__((target("avx2"))) static void sum_tuple_weights_avx2(const float* lut,
+																	 const TupleIndexBatch& idx,
+																	 int n, float* out) {
+	alignas(32) float lanes[MAX_MOVES];
+	const __m256 divisor = _mm256_set1_ps((float)TUPLE_NUM);
+	for (int m = 0; m < n; m += 8) {
+		__m256 total_weight = _mm256_setzero_ps();
+		for (int t = 0; t < TUPLE_NUM; t++) {
+			__m256i rows = _mm256_load_si256(reinterpret_cast<const __m256i*>(&idx[t][m]));
+			total_weight = _mm256_add_ps(total_weight, _mm256_i32gather_ps(lut, rows, 4));
 		}
-		if (is_valid_pattern(pos, offset_2x2)) {
-			total_weight += get_weight(pos, offset_2x2, d, feature_cache);
+		_mm256_store_ps(&lanes[m], _mm256_div_ps(total_weight, divisor));
+	}
+	for (int m = 0; m < n; m++) out[m] = lanes[m];
+}
+
+/**
+ * @brief AVX2 quantized kernel: gathers 4 bytes at each code and masks off the neighbours.
+ * * Reads stay inside the table thanks to QuantizedWeights' row padding.
+ */
+__attribute__((target("avx2"))) static void sum_tuple_codes_avx2(const lut_quant_t* lut,
+																   const TupleIndexBatch& idx,
+																   int n, int32_t* out) {
+	const int* base = reinterpret_cast<const int*>(lut);
+	const __m256i mask = _mm256_set1_epi32(QuantizedWeights::QMAX);
+	for (int m = 0; m < n; m += 8) {
+		__m256i code_sum = _mm256_setzero_si256();
+		for (int t = 0; t < TUPLE_NUM; t++) {
+			__m256i rows = _mm256_load_si256(reinterpret_cast<const __m256i*>(&idx[t][m]));
+			__m256i codes = _mm256_i32gather_epi32(base, rows, sizeof(lut_quant_t));
+			code_sum = _mm256_add_epi32(code_sum, _mm256_and_si256(codes, mask));
 		}
+		_mm256_store_si256(reinterpret_cast<__m256i*>(&out[m]), code_sum);
 	}
+}
 
-	return total_weight / (float)TUPLE_NUM;
+/**
+ * @brief AVX2 single-board kernel: 8 tuples per gather, scalar tail for the last 5.
+ */
+__attribute__((target("avx2"))) static int32_t sum_board_codes_avx2(const lut_quant_t* lut,
+																	  const uint8_t* feature) {
+	const int* base = reinterpret_cast<const int*>(lut);
+	const __m256i mask = _mm256_set1_epi32(QuantizedWeights::QMAX);
+	__m256i code_sum = _mm256_setzero_si256();
+	int t = 0;
+	for (; t + 8 <= TUPLE_NUM; t += 8) {
+		__m256i f = _mm256_cvtepu8_epi32(
+			_mm_loadl_epi64(reinterpret_cast<const __m128i*>(feature + t)));
+		__m256i rows = _mm256_add_epi32(
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&TUPLES.lut_offset[t])), f);
+		__m256i codes = _mm256_i32gather_epi32(base, rows, sizeof(lut_quant_t));
+		code_sum = _mm256_add_epi32(code_sum, _mm256_and_si256(codes, mask));
+	}
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(code_sum),
+								 _mm256_extracti128_si256(code_sum, 1));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+	int32_t total = _mm_cvtsi128_si32(half);
+	for (; t < TUPLE_NUM; t++) total += lut[TUPLES.lut_offset[t] + feature[t]];
+	return total;
 }
+#endif
 
 /**
- * @brief Selects the highest weighted move (Greedy Policy).
- * * Includes optimizations for corner bonuses and pre-computation.
+ * @brief Scores every candidate as highest_weight's simulated move would.
+ * * A candidate only changes the tuples covering its source and destination squares,
+ * * so its features are the current ones plus two sparse deltas. Captures happen on a
+ * * masked board and never change piece_nums, hence one LUT serves the whole batch.
  */
-int GST::highest_weight(DATA& d) {
-	float WEIGHT[MAX_MOVES] = {0};
-	int root_nmove;
-	int root_moves[MAX_MOVES];
-	root_nmove = gen_all_move(root_moves);
+template <int Side>
+void GST::candidate_rows_as(const int* moves, int n, TupleIndexBatch idx) {
+	constexpr int sign = Side == USER ? 1 : -1;
+	int (*const feature)(int) = Side == USER ? feature_user : feature_enemy;
+
+	const uint8_t* root = tuple_feature[Side];
+	for (int t = 0; t < TUPLE_NUM; t++) {
+		const int32_t row = TUPLES.lut_offset[t] + root[t];
+		for (int m = 0; m < MAX_MOVES; m++) idx[t][m] = row;  // Padding lanes stay valid
+	}
+
+	for (int m = 0; m < n; m++) {
+		int piece = moves[m] >> 4;
+		int direction = moves[m] & 0xf;
+		int src = pos[piece];
 
-	// Store distances from pieces to corners
-	std::vector<std::tuple<int, int, int>> pieces_distances;  // (piece_idx, corner_id, distance)
+		// Escaping leaves the board untouched
+		if (color[piece] == sign * BLUE && check_win_move(src, direction)) continue;
 
-	if (nowTurn == USER) {
-		// Calculate for all User pieces
-		for (int i = 0; i < PIECES; i++) {
-			if (pos[i] != -1) {
-				int p_row = pos[i] / 6;
-				int p_col = pos[i] % 6;
-
-				// Manhattan distance to 4 corners
-				int dist_to_0 = p_row + p_col;
-				int dist_to_5 = p_row + (5 - p_col);
-				int dist_to_30 = (5 - p_row) + p_col;
-				int dist_to_35 = (5 - p_row) + (5 - p_col);
-
-				// Add to list
-				pieces_distances.push_back(std::make_tuple(i, 0, dist_to_0));
-				pieces_distances.push_back(std::make_tuple(i, 1, dist_to_5));
-				pieces_distances.push_back(std::make_tuple(i, 2, dist_to_30));
-				pieces_distances.push_back(std::make_tuple(i, 3, dist_to_35));
-			}
+		int dst = src + dir_val[direction];
+		const int d_src = -feature(board[src]);
+		const int d_dst = feature(color[piece]) - feature(board[dst]);
+		for (int c = 0; c < tuple_cover.count[src]; c++) {
+			const auto& e = tuple_cover.cover[src][c];
+			idx[e.tuple][m] += d_src * e.weight;
 		}
-	} else if (nowTurn == ENEMY) {
-		// Calculate for all Enemy pieces
-		for (int i = PIECES; i < PIECES * 2; i++) {
-			if (pos[i] != -1) {
-				int p_row = pos[i] / 6;
-				int p_col = pos[i] % 6;
-
-				int dist_to_0 = p_row + p_col;
-				int dist_to_5 = p_row + (5 - p_col);
-				int dist_to_30 = (5 - p_row) + p_col;
-				int dist_to_35 = (5 - p_row) + (5 - p_col);
-
-				pieces_distances.push_back(std::make_tuple(i, 0, dist_to_0));
-				pieces_distances.push_back(std::make_tuple(i, 1, dist_to_5));
-				pieces_distances.push_back(std::make_tuple(i, 2, dist_to_30));
-				pieces_distances.push_back(std::make_tuple(i, 3, dist_to_35));
-			}
+		for (int c = 0; c < tuple_cover.count[dst]; c++) {
+			const auto& e = tuple_cover.cover[dst][c];
+			idx[e.tuple][m] += d_dst * e.weight;
+		}
+	}
+}
+
+template <int Side>
+void GST::evaluate_moves_as(const InferenceWeights& d, const int* moves, int n, float* out) {
+	alignas(32) TupleIndexBatch idx;
+	candidate_rows_as<Side>(moves, n, idx);
+	const float* lut = d.table(lut_table_as<Side>());
+
+#if EVAL_AVX2
+	if (cpu_has_avx2()) {
+		sum_tuple_weights_avx2(lut, idx, n, out);
+		return;
+	}
+#endif
+	sum_tuple_weights_scalar(lut, idx, n, out);
+}
+
+/**
+ * @brief Quantized batch: integer code sums per candidate, dequantized once each.
+ */
+template <int Side>
+void GST::evaluate_moves_as(const QuantizedWeights& d, const int* moves, int n, float* out) {
+	alignas(32) TupleIndexBatch idx;
+	candidate_rows_as<Side>(moves, n, idx);
+	const int table = lut_table_as<Side>();
+	alignas(32) int32_t code_sum[MAX_MOVES];
+
+#if EVAL_AVX2
+	if (cpu_has_avx2())
+		sum_tuple_codes_avx2(d.lut[table], idx, n, code_sum);
+	else
+#endif
+		sum_tuple_codes_scalar(d.lut[table], idx, n, code_sum);
+	for (int m = 0; m < n; m++) out[m] = d.dequantize(table, code_sum[m]);
+}
+
+void GST::evaluate_moves(const InferenceWeights& d, const int* moves, int n, float* out) {
+	if (nowTurn == USER)
+		evaluate_moves_as<USER>(d, moves, n, out);
+	else
+		evaluate_moves_as<ENEMY>(d, moves, n, out);
+}
+
+void GST::evaluate_moves(const QuantizedWeights& d, const int* moves, int n, float* out) {
+	if (nowTurn == USER)
+		evaluate_moves_as<USER>(d, moves, n, out);
+	else
+		evaluate_moves_as<ENEMY>(d, moves, n, out);
+}
+
+/**
+ * @brief Quantized evaluation: integer code sum of the 61 tuples (exact in any order).
+ */
+template <int Side>
+float GST::compute_board_weight_as(const QuantizedWeights& d) {
+	const int table = lut_table_as<Side>();
+	const lut_quant_t* lut = d.lut[table];
+
+	const uint8_t* feature = tuple_feature[Side];
+#if !INCREMENTAL_EVAL
+	uint8_t board_feature[TUPLE_NUM];
+	int (*const square_feature)(int) = Side == USER ? feature_user : feature_enemy;
+	for (int t = 0; t < TUPLE_NUM; t++) {
+		const int* sq = TUPLES.lut_square[t];
+		board_feature[t] = square_feature(board[sq[0]]) * 64 + square_feature(board[sq[1]]) * 16 +
+						   square_feature(board[sq[2]]) * 4 + square_feature(board[sq[3]]);
+	}
+	feature = board_feature;
+#endif
+
+#if EVAL_AVX2
+	if (cpu_has_avx2()) return d.dequantize(table, sum_board_codes_avx2(lut, feature));
+#endif
+	int32_t code_sum = 0;
+	for (int t = 0; t < TUPLE_NUM; t++) code_sum += lut[TUPLES.lut_offset[t] + feature[t]];
+	return d.dequantize(table, code_sum);
+}
+
+float GST::compute_board_weight(const QuantizedWeights& d) {
+	return nowTurn == USER ? compute_board_weight_as<USER>(d) : compute_board_weight_as<ENEMY>(d);
+}
+
+/**
+ * @brief Scores one candidate by playing it on a board with the opponent's colors hidden.
+ */
+template <class Weights>
+float GST::evaluate_move_as(const Weights& d, int move) {
+	int tmp_color[PIECES * 2];	// Backup colors (Remove God View)
+	for (int i = 0; i < PIECES * 2; i++) tmp_color[i] = color[i];
+
+	// Mask hidden info
+	if (nowTurn == USER)
+		for (int i = PIECES; i < PIECES * 2; i++) color[i] = -UNKNOWN;
+	else
+		for (int i = 0; i < PIECES; i++) color[i] = UNKNOWN;
+
+	// undo() restores a captured piece's square from the masked color; keep its real value
+	const int dst = pos[move >> 4] + dir_val[move & 0xf];
+	const bool on_board = dst >= 0 && dst < ROW * COL;	// Escapes leave the board
+	const int dst_value = on_board ? board[dst] : 0;
+
+	do_move(move);
+	nowTurn ^= 1;
+
+	float weight = compute_board_weight(d);
+
+	nowTurn ^= 1;
+	undo();
+
+	// Restore colors
+	for (int i = 0; i < PIECES * 2; i++) color[i] = tmp_color[i];
+	if (on_board && board[dst] != dst_value) {
+		const int old_value = board[dst];
+		board[dst] = dst_value;
+		update_features(dst, old_value);
+	}
+	return weight;
+}
+
+float GST::evaluate_move(const InferenceWeights& d, int move) { return evaluate_move_as(d, move); }
+float GST::evaluate_move(const QuantizedWeights& d, int move) { return evaluate_move_as(d, move); }
+
+/**
+ * @brief Scores the candidates the way the greedy policy ranks them.
+ * * Includes optimizations for corner bonuses and pre-computation.
+ */
+template <int Side, class Weights>
+void GST::score_moves_as(const Weights& d, const int* root_moves, int root_nmove, float* WEIGHT) {
+	constexpr int sign = Side == USER ? 1 : -1;	 // Own colors are sign * RED / BLUE
+	for (int m = 0; m < root_nmove; m++) WEIGHT[m] = 0;
+
+#if BATCH_EVAL
+	float batch_weight[MAX_MOVES];
+	evaluate_moves_as<Side>(d, root_moves, root_nmove, batch_weight);
+#endif
+
+	// Store distances from pieces to corners (fixed buffer: at most 4 corners per piece)
+	struct PieceCorner {
+		int piece, corner, dist;
+	};
+	PieceCorner pieces_distances[PIECES * 4];
+	int n_distances = 0;
+
+	// Calculate for all pieces of the side to move
+	constexpr int offset = Side == ENEMY ? PIECES : 0;
+	for (int i = offset; i < offset + PIECES; i++) {
+		if (pos[i] != -1) {
+			int p_row = pos[i] / 6;
+			int p_col = pos[i] % 6;
+
+			// Manhattan distance to 4 corners
+			int dist_to_0 = p_row + p_col;
+			int dist_to_5 = p_row + (5 - p_col);
+			int dist_to_30 = (5 - p_row) + p_col;
+			int dist_to_35 = (5 - p_row) + (5 - p_col);
+
+			// Add to list
+			pieces_distances[n_distances++] = {i, 0, dist_to_0};
+			pieces_distances[n_distances++] = {i, 1, dist_to_5};
+			pieces_distances[n_distances++] = {i, 2, dist_to_30};
+			pieces_distances[n_distances++] = {i, 3, dist_to_35};
 		}
 	}
 
 	// Sort all piece-corner tuples by distance
-	std::sort(pieces_distances.begin(), pieces_distances.end(),
-			  [](const std::tuple<int, int, int>& a, const std::tuple<int, int, int>& b) {
-				  return std::get<2>(a) < std::get<2>(b);
-			  });
+	std::sort(pieces_distances, pieces_distances + n_distances,
+			  [](const PieceCorner& a, const PieceCorner& b) { return a.dist < b.dist; });
 
 	// Tracking assigned pieces and corners
 	bool piece_assigned[PIECES * 2];
@@ -724,9 +1176,9 @@ int GST::highest_weight(DATA& d) {
 	memset(assigned_corner_for_piece, -1, sizeof(assigned_corner_for_piece));
 
 	// Assign closest pieces to corners
-	for (const auto& tuple : pieces_distances) {
-		int p_idx = std::get<0>(tuple);
-		int corner = std::get<1>(tuple);
+	for (int t = 0; t < n_distances; t++) {
+		int p_idx = pieces_distances[t].piece;
+		int corner = pieces_distances[t].corner;
 
 		if (!piece_assigned[p_idx] && !corner_assigned[corner]) {
 			piece_assigned[p_idx] = true;
@@ -747,55 +1199,53 @@ int GST::highest_weight(DATA& d) {
 		int dst = src + dir_val[direction];	 // the position after move
 
 		// Immediate win checks or special heuristics
-		if (pos[piece] == 0 && direction == 1 && nowTurn == USER && board[0] == BLUE) {
+		if (pos[piece] == 0 && direction == 1 && Side == USER && board[0] == BLUE) {
 			WEIGHT[move_index] = 1;
-		} else if (pos[piece] == 5 && direction == 2 && nowTurn == USER && board[5] == BLUE) {
+		} else if (pos[piece] == 5 && direction == 2 && Side == USER && board[5] == BLUE) {
 			WEIGHT[move_index] = 1;
-		} else if (pos[piece] == 30 && direction == 1 && nowTurn == ENEMY && board[30] == -BLUE) {
+		} else if (pos[piece] == 30 && direction == 1 && Side == ENEMY && board[30] == -BLUE) {
 			WEIGHT[move_index] = 1;
-		} else if (pos[piece] == 35 && direction == 2 && nowTurn == ENEMY && board[35] == -BLUE) {
+		} else if (pos[piece] == 35 && direction == 2 && Side == ENEMY && board[35] == -BLUE) {
 			WEIGHT[move_index] = 1;
-		} else if (pos[piece] == 4 && direction == 2 && nowTurn == USER && color[piece] == BLUE) {
+		} else if (pos[piece] == 4 && direction == 2 && Side == USER && color[piece] == BLUE) {
 			if (board[5] == 0 && board[11] >= 0) {
 				WEIGHT[move_index] = 1;
 			}
-		} else if (pos[piece] == 1 && direction == 1 && nowTurn == USER && color[piece] == BLUE) {
+		} else if (pos[piece] == 1 && direction == 1 && Side == USER && color[piece] == BLUE) {
 			if (board[0] == 0 && board[6] >= 0) {
 				WEIGHT[move_index] = 1;
 			}
-		} else if (pos[piece] == 34 && direction == 2 && nowTurn == ENEMY &&
+		} else if (pos[piece] == 34 && direction == 2 && Side == ENEMY &&
 				   color[piece] == -BLUE) {
 			if (board[35] == 0 && board[29] <= 0) {
 				WEIGHT[move_index] = 1;
 			}
-		} else if (pos[piece] == 31 && direction == 1 && nowTurn == ENEMY &&
+		} else if (pos[piece] == 31 && direction == 1 && Side == ENEMY &&
 				   color[piece] == -BLUE) {
 			if (board[30] == 0 && board[24] <= 0) {
 				WEIGHT[move_index] = 1;
 			}
 		} else {
 			// General case: Simulate move and evaluate board
-			int tmp_color[PIECES * 2];	// Backup colors (Remove God View)
-			for (int i = 0; i < PIECES * 2; i++) tmp_color[i] = color[i];
-
-			// Mask hidden info
-			if (nowTurn == USER)
-				for (int i = PIECES; i < PIECES * 2; i++) color[i] = -UNKNOWN;
-			else
-				for (int i = 0; i < PIECES; i++) color[i] = UNKNOWN;
-
-			do_move(root_moves[m]);
-			nowTurn ^= 1;
-
-			WEIGHT[move_index] = compute_board_weight(d);
-
-			nowTurn ^= 1;
-			undo();
-
-			// Restore colors
-			for (int i = 0; i < PIECES * 2; i++) color[i] = tmp_color[i];
+#if BATCH_EVAL
+			WEIGHT[move_index] = batch_weight[m];
+#ifdef EVAL_CROSSCHECK
+			const float reference = evaluate_move(d, root_moves[m]);
+			if (WEIGHT[move_index] != reference) {
+				fprintf(stderr, "evaluate_moves mismatch: batched %.9g, per-move %.9g\n",
+						WEIGHT[move_index], reference);
+				exit(1);
+			}
+#endif
+#else
+			WEIGHT[move_index] = evaluate_move(d, root_moves[m]);
+#endif
 		}
 
+		// An escape leaves the board: dst is off it (-1 / 36) or wrapped into the next row
+		// (6 / 29), so neither the corner nor the quiet bonus applies
+		if (color[piece] == sign * BLUE && check_win_move(src, direction)) continue;
+
 		// Apply Corner Heuristics
 		int row = dst / 6;
 		int col = dst % 6;
@@ -845,22 +1295,63 @@ int GST::highest_weight(DATA& d) {
 			WEIGHT[move_index] *= 1.01;
 		}
 	}
+}
 
-	// Final Selection Logic (Softmax / Linear / Argmax)
+void GST::score_moves(const InferenceWeights& d, const int* moves, int n, float* weight) {
+	if (nowTurn == USER)
+		score_moves_as<USER>(d, moves, n, weight);
+	else
+		score_moves_as<ENEMY>(d, moves, n, weight);
+}
+void GST::score_moves(const QuantizedWeights& d, const int* moves, int n, float* weight) {
+	if (nowTurn == USER)
+		score_moves_as<USER>(d, moves, n, weight);
+	else
+		score_moves_as<ENEMY>(d, moves, n, weight);
+}
+
+/**
+ * @brief Selects the highest weighted move of side 'Side' (Greedy Policy).
+ */
+template <int Side, class Weights>
+int GST::highest_weight_as(const Weights& d, pcg32& gen) {
+	int root_moves[MAX_MOVES];
+	int root_nmove = gen_all_move_as<Side>(root_moves);
+	float WEIGHT[MAX_MOVES];
+	score_moves_as<Side>(d, root_moves, root_nmove, WEIGHT);
+	return root_moves[select_move(WEIGHT, root_nmove, gen)];
+}
+
+int GST::highest_weight(const InferenceWeights& d, pcg32* policy) {
+	pcg32& gen = policy ? *policy : rng;
+	return nowTurn == USER ? highest_weight_as<USER>(d, gen) : highest_weight_as<ENEMY>(d, gen);
+}
+
+int GST::highest_weight(const QuantizedWeights& d, pcg32* policy) {
+	pcg32& gen = policy ? *policy : rng;
+	return nowTurn == USER ? highest_weight_as<USER>(d, gen) : highest_weight_as<ENEMY>(d, gen);
+}
+
+void GST::seed_policy(uint64_t seed) { rng.seed(seed); }
+
+/**
+ * @brief Final Selection Logic (Softmax / Linear / Argmax) over the candidate scores.
+ */
+int GST::select_move(const float* WEIGHT, int root_nmove, pcg32& gen) {
 	float max_weight = -std::numeric_limits<float>::infinity();
 	float min_weight = std::numeric_limits<float>::infinity();
-	std::vector<int> best_candidates;
-	best_candidates.reserve(root_nmove);
+	int best_candidates[MAX_MOVES];
+	int n_best = 0;
 
 	for (int i = 0; i < root_nmove; ++i) {
 		const float wi = WEIGHT[i];
 		if (!(wi == wi)) continue;	// Skip NaN
 		if (wi > max_weight) {
 			max_weight = wi;
-			best_candidates.clear();
-			best_candidates.push_back(i);
+			n_best = 0;
+			best_candidates[n_best++] = i;
 		} else if (wi == max_weight) {
-			best_candidates.push_back(i);
+			best_candidates[n_best++] = i;
 		}
 		if (wi < min_weight) {
 			min_weight = wi;
@@ -868,8 +1359,8 @@ int GST::highest_weight(DATA& d) {
 	}
 
 	int best_idx = -1;
-	if (!best_candidates.empty()) {
-		best_idx = best_candidates[rng(best_candidates.size())];
+	if (n_best > 0) {
+		best_idx = best_candidates[gen(n_best)];
 	}
 	if (best_idx < 0) {
 		best_idx = 0;  // Fallback
@@ -883,7 +1374,7 @@ int GST::highest_weight(DATA& d) {
 	// Softmax Probability Sampling
 	const double temperature = 1.0;
 	const double T = std::max(1e-9, temperature);
-	std::vector<double> probs(root_nmove, 0.0);
+	double probs[MAX_MOVES] = {0.0};
 	double sumProb = 0.0;
 	for (int i = 0; i < root_nmove; i++) {
 		double wi = static_cast<double>(WEIGHT[i]);
@@ -897,7 +1388,7 @@ int GST::highest_weight(DATA& d) {
 		sumProb += v;
 	}
 	if (sumProb > 0.0 && std::isfinite(sumProb)) {
-		double u = next_u01();
+		double u = next_u01(gen);
 		double target = u * sumProb;
 		double acc = 0.0;
 		for (int i = 0; i < root_nmove; i++) {
@@ -912,7 +1403,7 @@ int GST::highest_weight(DATA& d) {
 #elif SELECTION_MODE == 1
 	// Linear Weight Sampling (Shift negative values)
 	const double shift = (min_weight < 0.0f) ? -static_cast<double>(min_weight) : 0.0;
-	std::vector<double> w(root_nmove, 0.0);
+	double w[MAX_MOVES] = {0.0};
 	double sumW = 0.0;
 	for (int i = 0; i < root_nmove; i++) {
 		double wi = static_cast<double>(WEIGHT[i]);
@@ -926,7 +1417,7 @@ int GST::highest_weight(DATA& d) {
 		sumW += vi;
 	}
 	if (sumW > 0.0 && std::isfinite(sumW)) {
-		double u = next_u01();
+		double u = next_u01(gen);
 		double target = u * sumW;
 		double acc = 0.0;
 		for (int i = 0; i < root_nmove; i++) {
@@ -944,5 +1435,5 @@ int GST::highest_weight(DATA& d) {
 
 	// Final safety check
 	if (chosen_idx < 0 || chosen_idx >= root_nmove) chosen_idx = best_idx;
-	return root_moves[chosen_idx];
+	return chosen_idx;
 }
\ No newline at end of file
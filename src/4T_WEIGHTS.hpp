@@ -0,0 +1,368 @@
+/**
+ * @file 4T_WEIGHTS.hpp
+ * @brief Read-only N-Tuple weights used at inference time.
+ * * Holds only the six float win-rate LUTs the search reads; the training counters stay in DATA.
+ * * Also defines the compile-time tuple geometry (TUPLES) that indexes them.
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#ifndef WEIGHTS_HPP
+#define WEIGHTS_HPP
+
+#include "4T_header.h"
+
+class DATA;
+
+// =============================
+// 4-Tuple Geometry
+// =============================
+
+// LUT_MIRROR = 1 -> tuples that are left-right mirror images share one LUT row; the loaders
+//                   pool their training counts (36 rows instead of 61)
+// LUT_MIRROR = 0 -> one LUT row per tuple, exactly as trained (Default)
+#ifndef LUT_MIRROR
+#define LUT_MIRROR 0
+#endif
+
+/// @brief Tuple shapes, in the order they are enumerated for each base square
+enum TupleShape { SHAPE_1X4, SHAPE_4X1, SHAPE_2X2, TUPLE_SHAPES };
+
+/// Square reflected across the vertical axis (the board and both exit pairs are symmetric)
+constexpr int mirror_square(int sq) { return sq - sq % COL + (COL - 1 - sq % COL); }
+
+/**
+ * @struct TupleTable
+ * @brief Compile-time description of the 61 tuples.
+ * * Tuples are numbered square by square (1x4, 4x1, 2x2 where each fits). Features in the
+ * * CSVs read the squares in 'square' order. The LUTs are indexed by lut_offset[t] plus the
+ * * feature read in 'lut_square' order: without LUT_MIRROR these are row t and 'square'; with
+ * * it, the later tuple of a mirror pair reads the reflection of the earlier one's squares and
+ * * shares its row.
+ */
+struct TupleTable {
+	int square[TUPLE_NUM][4];		  ///< Squares of each tuple, most significant digit first
+	int id[ROW * COL][TUPLE_SHAPES];  ///< Tuple of (base square, shape), -1 if it does not fit
+	int count;						  ///< Number of tuples generated (== TUPLE_NUM)
+
+	/// @name Mirror Symmetry
+	/// @{
+	int mirror[TUPLE_NUM];			 ///< Tuple covering the reflected squares (may be itself)
+	int mirror_digit[TUPLE_NUM][4];	 ///< Digit of the mirror tuple that square k reflects to
+	int lut_square[TUPLE_NUM][4];	 ///< Square order of the LUT feature index
+	int lut_digit[TUPLE_NUM][4];	 ///< Digit of 'square' order read as LUT digit k
+	int lut_offset[TUPLE_NUM];		 ///< First LUT entry of the tuple's row
+	int rows;						 ///< LUT rows per table
+	/// @}
+};
+
+constexpr TupleTable make_tuple_table() {
+	TupleTable table{};
+	const int offsets[TUPLE_SHAPES][4] = {
+		{0, 1, 2, 3}, {0, COL, 2 * COL, 3 * COL}, {0, 1, COL, COL + 1}};
+	for (int base = 0; base < ROW * COL; base++) {
+		const int row = base / COL, col = base % COL;
+		const bool fits[TUPLE_SHAPES] = {col <= COL - 4, row <= ROW - 4,
+										 col <= COL - 2 && row <= ROW - 2};
+		for (int s = 0; s < TUPLE_SHAPES; s++) {
+			table.id[base][s] = -1;
+			if (!fits[s]) continue;
+			for (int k = 0; k < 4; k++) table.square[table.count][k] = base + offsets[s][k];
+			table.id[base][s] = table.count++;
+		}
+	}
+
+	// Pair every tuple with the one covering its reflection
+	for (int t = 0; t < table.count; t++) {
+		for (int m = 0; m < table.count; m++) {
+			int matched = 0;
+			for (int k = 0; k < 4; k++)
+				for (int j = 0; j < 4; j++)
+					if (table.square[m][j] == mirror_square(table.square[t][k])) {
+						table.mirror_digit[t][k] = j;
+						matched++;
+					}
+			if (matched == 4) {
+				table.mirror[t] = m;
+				break;
+			}
+		}
+	}
+
+	// LUT layout: the earlier tuple of a pair keeps its own order, the later one reads the
+	// reflection of it
+	for (int t = 0; t < table.count; t++) {
+		const int m = table.mirror[t];
+		const bool shared = LUT_MIRROR && m < t;
+		for (int k = 0; k < 4; k++) {
+			table.lut_square[t][k] =
+				shared ? mirror_square(table.square[m][k]) : table.square[t][k];
+			for (int j = 0; j < 4; j++)
+				if (table.square[t][j] == table.lut_square[t][k]) table.lut_digit[t][k] = j;
+		}
+		table.lut_offset[t] = shared ? table.lut_offset[m] : table.rows++ * FEATURE_NUM;
+	}
+	return table;
+}
+
+/// Tuple geometry shared by every GST backend
+constexpr TupleTable TUPLES = make_tuple_table();
+static_assert(TUPLES.count == TUPLE_NUM, "tuple enumeration must produce TUPLE_NUM tuples");
+
+/// LUT rows per table (TUPLE_NUM, or the number of mirror classes with LUT_MIRROR)
+constexpr int LUT_ROWS = TUPLES.rows;
+
+/**
+ * @brief Feature of tuple t (digits in 'square' order) re-read in its 'lut_square' order.
+ */
+constexpr int lut_feature(int t, int feature) {
+#if LUT_MIRROR
+	int lut = 0;
+	for (int k = 0; k < 4; k++) lut = lut * 4 + ((feature >> (2 * (3 - TUPLES.lut_digit[t][k]))) & 3);
+	return lut;
+#else
+	static_cast<void>(t);
+	return feature;
+#endif
+}
+
+/**
+ * @brief Feature of the reflected pattern, in the digit order of tuple TUPLES.mirror[t].
+ */
+constexpr int mirror_feature(int t, int feature) {
+	int mirrored = 0;
+	for (int k = 0; k < 4; k++)
+		mirrored |= ((feature >> (2 * (3 - k))) & 3) << (2 * (3 - TUPLES.mirror_digit[t][k]));
+	return mirrored;
+}
+
+/**
+ * @brief Pools the counters of every pattern with its reflection (full TUPLE_NUM layout,
+ * * indexed like DATA) and gives both the pooled win rate.
+ * * The two rows keep halves of the pooled counters (the first one the odd count), so
+ * * the pair still sums to the pooled totals and folding again changes nothing.
+ */
+void fold_mirror_counts(unsigned long long* wins, unsigned long long* visits, float* win_rate);
+
+/// @brief LUTs in InferenceWeights member order (also their order in a weight file)
+enum WeightTable { TABLE_U, TABLE_E, TABLE_U_R1, TABLE_E_R1, TABLE_U_B1, TABLE_E_B1, WEIGHT_TABLES };
+
+/**
+ * @class InferenceWeights
+ * @brief The six win-rate LUTs in one contiguous, cache-line aligned block (~366 KiB).
+ * * Every table is LUT_ROWS * FEATURE_NUM floats (a multiple of 64 bytes), so all six start
+ * * on a cache line. LUT_idx(location, feature) takes DATA's (tuple, feature) coordinates.
+ */
+class alignas(64) InferenceWeights {
+   public:
+	static constexpr int TABLE_SIZE = LUT_ROWS * FEATURE_NUM;	///< Floats per LUT
+
+	/// @name Win-Rate Look-Up Tables
+	/// @{
+	// _U: User perspective, _E: Enemy perspective
+	// R1: the opponent has 1 Red piece left, B1: the perspective side has 1 Blue piece left
+	float LUTwr_U[TABLE_SIZE];
+	float LUTwr_E[TABLE_SIZE];
+	float LUTwr_U_R1[TABLE_SIZE];
+	float LUTwr_E_R1[TABLE_SIZE];
+	float LUTwr_U_B1[TABLE_SIZE];
+	float LUTwr_E_B1[TABLE_SIZE];
+	/// @}
+
+	/**
+	 * @brief Initializes every win rate to 0.5 (same default as DATA::init_data).
+	 */
+	InferenceWeights();
+
+	/**
+	 * @brief Computes the index in the Linear LUT array.
+	 * @param location The N-Tuple location index (1 ~ TUPLE_NUM).
+	 * @param feature The feature pattern index (0 ~ FEATURE_NUM-1), digits in TUPLES.square order.
+	 */
+	static int LUT_idx(int location, int feature) {
+		return TUPLES.lut_offset[location - 1] + lut_feature(location - 1, feature);
+	}
+
+	/**
+	 * @brief The LUT with the given WeightTable number (tables are laid out back to back).
+	 */
+	const float* table(int t) const { return reinterpret_cast<const float*>(this) + t * TABLE_SIZE; }
+	float* table(int t) { return reinterpret_cast<float*>(this) + t * TABLE_SIZE; }
+
+	/**
+	 * @brief Copies the win-rate tables out of a training DATA instance.
+	 */
+	void copy_from(const DATA& training);
+
+	/**
+	 * @brief Loads the win-rate column of the standard weight files (./data).
+	 * @param num The iteration number/ID of the weight file to load.
+	 * @return true if both the U and E files were read.
+	 */
+	bool read_data_file(int num);
+
+	/// @name Specialized I/O Methods (R1/B1 Scenarios)
+	/// @{
+	bool read_data_file_R1(int num);
+	bool read_data_file_B1(int num);
+	/// @}
+};
+
+static_assert(sizeof(InferenceWeights) == WEIGHT_TABLES * InferenceWeights::TABLE_SIZE * sizeof(float),
+			  "InferenceWeights must be exactly the six LUTs, back to back");
+
+// =============================
+// Quantized Weights
+// =============================
+
+// LUT_QUANT_BITS = 16 / 8 -> the search evaluates with QuantizedWeights (integer sums)
+// LUT_QUANT_BITS = 0      -> the search evaluates with the float InferenceWeights (Default)
+// The quantized type itself always exists (16-bit unless 8 is requested) for quant_report.
+#ifndef LUT_QUANT_BITS
+#define LUT_QUANT_BITS 0
+#endif
+#if LUT_QUANT_BITS == 8
+typedef uint8_t lut_quant_t;
+#else
+typedef uint16_t lut_quant_t;
+#endif
+
+/**
+ * @class QuantizedWeights
+ * @brief InferenceWeights rounded to lut_quant_t with a per-table affine scale.
+ * * Entry q of table t stands for base[t] + q * step[t]; a board's value is then
+ * * base + step * (sum of its 61 entries) / 61, so evaluation accumulates integers.
+ * * 16-bit tables take half the float footprint (~183 KiB for all six), 8-bit a quarter.
+ */
+class alignas(64) QuantizedWeights {
+   public:
+	static constexpr int QMAX = (1 << (8 * sizeof(lut_quant_t))) - 1;  ///< Largest code
+	/// Row stride of a table: the LUT plus 64 bytes of zero padding (kernels load 4-byte words)
+	static constexpr int TABLE_STRIDE =
+		InferenceWeights::TABLE_SIZE + 64 / static_cast<int>(sizeof(lut_quant_t));
+
+	lut_quant_t lut[WEIGHT_TABLES][TABLE_STRIDE];  ///< Codes, indexed like InferenceWeights
+	float base[WEIGHT_TABLES];					   ///< Value of code 0 (table minimum)
+	float step[WEIGHT_TABLES];					   ///< Value of one code step
+
+	/**
+	 * @brief Quantizes every table of 'w' (round to nearest over the table's [min, max]).
+	 */
+	explicit QuantizedWeights(const InferenceWeights& w);
+
+	/**
+	 * @brief Board value from the integer sum of its 61 codes in table t.
+	 */
+	float dequantize(int t, int32_t code_sum) const {
+		return base[t] + step[t] * static_cast<float>(code_sum) / static_cast<float>(TUPLE_NUM);
+	}
+};
+
+/// Weights type the search evaluates with (see LUT_QUANT_BITS)
+#if LUT_QUANT_BITS
+typedef QuantizedWeights EvalWeights;
+#else
+typedef InferenceWeights EvalWeights;
+#endif
+
+// =============================
+// Binary Weight File
+// =============================
+
+/// Bumped whenever WeightFileHeader or the table layout changes
+constexpr uint32_t WEIGHT_FILE_VERSION = 1;
+
+/**
+ * @struct WeightFileHeader
+ * @brief First 64 bytes of a binary weight file; the six LUTs (little-endian float) follow.
+ * * The payload has exactly the InferenceWeights layout, so a mapped file is used in place.
+ */
+struct WeightFileHeader {
+	char magic[8];							 ///< "GSTWGHT" + NUL
+	uint32_t version;						 ///< WEIGHT_FILE_VERSION
+	uint32_t header_size;					 ///< sizeof(WeightFileHeader), offset of the first LUT
+	uint32_t tuple_num;						 ///< LUT_ROWS (TUPLE_NUM unless LUT_MIRROR)
+	uint32_t feature_num;					 ///< FEATURE_NUM
+	uint32_t table_count;					 ///< WEIGHT_TABLES
+	uint32_t trained_mask;					 ///< Bit t: table t came from CSV (else 0.5 default)
+	uint32_t table_checksum[WEIGHT_TABLES];	 ///< FNV-1a of each LUT
+	uint32_t header_checksum;				 ///< FNV-1a of every header byte before this field
+	uint32_t reserved;						 ///< Zero
+};
+static_assert(sizeof(WeightFileHeader) == 64, "weight file header must stay one cache line");
+
+/**
+ * @class WeightFile
+ * @brief Read-only memory mapping of a binary weight file or a shared weight segment.
+ * * open() checks the header and the U/E checksums, which pages those two tables in. The
+ * * R1/B1 tables are only paged in when an endgame position first reads them.
+ * * open_shared() maps a named shared-memory segment with the same layout, so concurrent
+ * * bot processes on one host keep a single physical copy of the tables.
+ */
+class WeightFile {
+   public:
+	WeightFile() = default;
+	~WeightFile() { close(); }
+	WeightFile(const WeightFile&) = delete;
+	WeightFile& operator=(const WeightFile&) = delete;
+
+	/**
+	 * @brief Maps 'path'; prints the reason to stderr and returns false if it is unusable.
+	 */
+	bool open(const std::string& path);
+
+	/// Fills the tables of a new segment and reports which ones are trained; false aborts
+	using Filler = std::function<bool(InferenceWeights&, uint32_t& trained_mask)>;
+
+	/**
+	 * @brief Attaches read-only to the named segment, creating it first if it does not exist.
+	 * * Only the creating process calls 'fill'; it publishes the header last, and later
+	 * * processes wait up to SHARED_ATTACH_TIMEOUT_MS for it before giving up. A segment
+	 * * whose creator died before publishing is unlinked and created again.
+	 * @param name POSIX shm name ("/name") or Windows mapping name ("Local\\name").
+	 */
+	bool open_shared(const std::string& name, const Filler& fill);
+
+	static constexpr int SHARED_ATTACH_TIMEOUT_MS = 5000;
+
+	/**
+	 * @brief Unmaps the file (weights() references become invalid).
+	 */
+	void close();
+
+	bool is_open() const { return header != nullptr; }
+	const WeightFileHeader& info() const { return *header; }
+
+	/**
+	 * @brief The mapped LUTs (valid while the file is open).
+	 */
+	const InferenceWeights& weights() const {
+		return *reinterpret_cast<const InferenceWeights*>(reinterpret_cast<const char*>(header) +
+														 header->header_size);
+	}
+
+	/**
+	 * @brief Recomputes one table's checksum (pages it in).
+	 */
+	bool verify(int t) const;
+
+	/**
+	 * @brief Writes 'w' as a binary weight file.
+	 * @param trained_mask Bit t set if table t holds trained (not default) weights.
+	 */
+	static bool write(const std::string& path, const InferenceWeights& w, uint32_t trained_mask);
+
+   private:
+	/**
+	 * @brief Checks the mapped header and the U/E checksums; unmaps and reports on failure.
+	 */
+	bool validate(const std::string& what);
+
+	const WeightFileHeader* header = nullptr;  ///< Start of the mapping
+	size_t mapped_size = 0;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#endif
+};
+
+#endif	// WEIGHTS_HPP
@@ -0,0 +1,441 @@
+/**
+ * @file 4T_WEIGHTS_impl.cpp
+ * @brief Implementation of InferenceWeights (win-rate LUT loading).
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#include "4T_WEIGHTS.hpp"
+
+#include "4T_DATA.hpp"
+#include "4T_header.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ==========================================
+// Initialization
+// ==========================================
+
+InferenceWeights::InferenceWeights() {
+	for (float* lut : {LUTwr_U, LUTwr_E, LUTwr_U_R1, LUTwr_E_R1, LUTwr_U_B1, LUTwr_E_B1})
+		std::fill_n(lut, TABLE_SIZE, 0.5f);
+}
+
+/**
+ * @brief Helper: Copies a full-layout (DATA) win-rate table into a LUT.
+ * * With LUT_MIRROR the source must already be folded; mirrored slots then agree.
+ */
+static void copy_win_rates(const float* full, float* lut) {
+#if LUT_MIRROR
+	for (int t = 0; t < TUPLE_NUM; t++)
+		for (int f = 0; f < FEATURE_NUM; f++)
+			lut[InferenceWeights::LUT_idx(t + 1, f)] = full[t * FEATURE_NUM + f];
+#else
+	memcpy(lut, full, InferenceWeights::TABLE_SIZE * sizeof(float));
+#endif
+}
+
+void InferenceWeights::copy_from(const DATA& training) {
+	copy_win_rates(training.LUTwr_U, LUTwr_U);
+	copy_win_rates(training.LUTwr_E, LUTwr_E);
+	copy_win_rates(training.LUTwr_U_R1, LUTwr_U_R1);
+	copy_win_rates(training.LUTwr_E_R1, LUTwr_E_R1);
+	copy_win_rates(training.LUTwr_U_B1, LUTwr_U_B1);
+	copy_win_rates(training.LUTwr_E_B1, LUTwr_E_B1);
+}
+
+// ==========================================
+// Mirror Folding
+// ==========================================
+
+void fold_mirror_counts(unsigned long long* wins, unsigned long long* visits, float* win_rate) {
+	for (int t = 0; t < TUPLE_NUM; t++) {
+		const int m = TUPLES.mirror[t];
+		for (int f = 0; f < FEATURE_NUM; f++) {
+			const int i = t * FEATURE_NUM + f;
+			const int j = m * FEATURE_NUM + mirror_feature(t, f);
+			if (j <= i) continue;  // Each pair once; symmetric patterns are their own reflection
+			// The pair's rows split the pooled counters, so they still sum to the totals:
+			// saving and folding again gives the same counters instead of doubling them
+			const unsigned long long w = wins[i] + wins[j], v = visits[i] + visits[j];
+			wins[i] = w - w / 2, wins[j] = w / 2;
+			visits[i] = v - v / 2, visits[j] = v / 2;
+			win_rate[i] = win_rate[j] = v ? static_cast<float>(w) / v : 0.5f;
+		}
+	}
+}
+
+// ==========================================
+// File I/O
+// ==========================================
+
+/**
+ * @brief Helper: Reads the win-rate column of one weight CSV into a LUT.
+ * * Rows are "location,feature,LUTw,LUTv,win rate"; the counters are skipped, except with
+ * * LUT_MIRROR, where they are pooled with the reflected pattern's before taking the rate.
+ * * Missing files leave the LUT at its current values.
+ */
+static bool read_win_rates(const std::string& filename, float* lut) {
+	std::ifstream in(filename, std::ios::in);
+	if (!in) {
+		printf("Missing %s, keeping default weights\n", filename.c_str());
+		return false;
+	}
+
+#if LUT_MIRROR
+	// Full-layout counters; rows missing from the file keep DATA's 1/2 prior
+	std::vector<unsigned long long> wins(TUPLE_NUM * FEATURE_NUM, 1), visits(wins.size(), 2);
+	std::vector<float> win_rate(wins.size(), 0.5f);
+#endif
+
+	std::string line;
+	getline(in, line);	// Header row
+	while (getline(in, line)) {
+		std::istringstream row(line);
+		std::string location, feature, field;
+		getline(row, location, ',');
+		getline(row, feature, ',');
+#if LUT_MIRROR
+		const int i = (std::stoi(location) - 1) * FEATURE_NUM + std::stoi(feature);
+		getline(row, field, ',');  // LUTw
+		wins[i] = std::stoull(field);
+		getline(row, field, ',');  // LUTv
+		visits[i] = std::stoull(field);
+		getline(row, field, ',');  // 4-tuple win rate
+		win_rate[i] = std::stof(field);
+#else
+		getline(row, field, ',');  // LUTw
+		getline(row, field, ',');  // LUTv
+		getline(row, field, ',');  // 4-tuple win rate
+		lut[InferenceWeights::LUT_idx(std::stoi(location), std::stoi(feature))] = std::stof(field);
+#endif
+	}
+
+#if LUT_MIRROR
+	fold_mirror_counts(wins.data(), visits.data(), win_rate.data());
+	copy_win_rates(win_rate.data(), lut);
+#endif
+	return true;
+}
+
+bool InferenceWeights::read_data_file(int num) {
+	bool e = read_win_rates("./data/Edata_" + std::to_string(num) + ".csv", LUTwr_E);
+	bool u = read_win_rates("./data/Udata_" + std::to_string(num) + ".csv", LUTwr_U);
+	return e && u;
+}
+
+bool InferenceWeights::read_data_file_R1(int num) {
+	bool e = read_win_rates("./data R1/Edata_" + std::to_string(num) + ".csv", LUTwr_E_R1);
+	bool u = read_win_rates("./data R1/Udata_" + std::to_string(num) + ".csv", LUTwr_U_R1);
+	return e && u;
+}
+
+bool InferenceWeights::read_data_file_B1(int num) {
+	bool e = read_win_rates("./data B1/Edata_" + std::to_string(num) + ".csv", LUTwr_E_B1);
+	bool u = read_win_rates("./data B1/Udata_" + std::to_string(num) + ".csv", LUTwr_U_B1);
+	return e && u;
+}
+
+// ==========================================
+// Quantized Weights
+// ==========================================
+
+QuantizedWeights::QuantizedWeights(const InferenceWeights& w) {
+	memset(lut, 0, sizeof(lut));
+	for (int t = 0; t < WEIGHT_TABLES; t++) {
+		const float* table = w.table(t);
+		auto range = std::minmax_element(table, table + InferenceWeights::TABLE_SIZE);
+		base[t] = *range.first;
+		step[t] = (*range.second - *range.first) / QMAX;
+		if (step[t] <= 0) continue;	 // Constant table: every code stays 0
+		for (int i = 0; i < InferenceWeights::TABLE_SIZE; i++)
+			lut[t][i] = static_cast<lut_quant_t>(std::lround((table[i] - base[t]) / step[t]));
+	}
+}
+
+// ==========================================
+// Binary Weight File
+// ==========================================
+
+static const char WEIGHT_FILE_MAGIC[8] = {'G', 'S', 'T', 'W', 'G', 'H', 'T', 0};
+
+/**
+ * @brief Helper: 32-bit FNV-1a hash.
+ */
+static uint32_t fnv1a(const void* data, size_t n) {
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < n; i++) {
+		hash ^= p[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @brief Helper: Builds the header describing 'w'.
+ */
+static WeightFileHeader make_header(const InferenceWeights& w, uint32_t trained_mask) {
+	WeightFileHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, WEIGHT_FILE_MAGIC, sizeof(h.magic));
+	h.version = WEIGHT_FILE_VERSION;
+	h.header_size = sizeof(WeightFileHeader);
+	h.tuple_num = LUT_ROWS;
+	h.feature_num = FEATURE_NUM;
+	h.table_count = WEIGHT_TABLES;
+	h.trained_mask = trained_mask;
+	for (int t = 0; t < WEIGHT_TABLES; t++)
+		h.table_checksum[t] = fnv1a(w.table(t), InferenceWeights::TABLE_SIZE * sizeof(float));
+	h.header_checksum = fnv1a(&h, offsetof(WeightFileHeader, header_checksum));
+	return h;
+}
+
+bool WeightFile::write(const std::string& path, const InferenceWeights& w, uint32_t trained_mask) {
+	WeightFileHeader h = make_header(w, trained_mask);
+
+	std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	out.write(reinterpret_cast<const char*>(&w), sizeof(InferenceWeights));
+	return static_cast<bool>(out);
+}
+
+bool WeightFile::open(const std::string& path) {
+	close();
+
+	// 1. Map the whole file read-only
+	const void* base = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+					   FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		fprintf(stderr, "%s: cannot open\n", path.c_str());
+		return false;
+	}
+	LARGE_INTEGER file_size;
+	GetFileSizeEx(file, &file_size);
+	size = static_cast<size_t>(file_size.QuadPart);
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping) base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "%s: cannot open\n", path.c_str());
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		size = static_cast<size_t>(st.st_size);
+		base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (base == MAP_FAILED) base = nullptr;
+	}
+	::close(fd);  // The mapping keeps the file alive
+#endif
+	header = static_cast<const WeightFileHeader*>(base);
+	mapped_size = size;
+	if (!header) {
+		fprintf(stderr, "%s: cannot map\n", path.c_str());
+		close();
+		return false;
+	}
+
+	return validate(path);
+}
+
+bool WeightFile::validate(const std::string& what) {
+	// 1. Layout and header checksum
+	const WeightFileHeader& h = *header;
+	const size_t size = mapped_size;
+	const char* reason = nullptr;
+	if (size < sizeof(WeightFileHeader) || memcmp(h.magic, WEIGHT_FILE_MAGIC, sizeof(h.magic)))
+		reason = "not a weight file";
+	else if (h.version != WEIGHT_FILE_VERSION)
+		reason = "unsupported version";
+	else if (h.header_checksum != fnv1a(&h, offsetof(WeightFileHeader, header_checksum)))
+		reason = "corrupt header";
+	else if (h.header_size != sizeof(WeightFileHeader) || h.tuple_num != LUT_ROWS ||
+			 h.feature_num != FEATURE_NUM || h.table_count != WEIGHT_TABLES ||
+			 size != h.header_size + sizeof(InferenceWeights))
+		reason = "table layout mismatch";
+
+	// 2. The U/E tables are read every move: check them now (this also pages them in).
+	//    R1/B1 stay untouched until the endgame needs them.
+	else if (!verify(TABLE_U) || !verify(TABLE_E))
+		reason = "table checksum mismatch";
+
+	if (reason) {
+		fprintf(stderr, "%s: %s\n", what.c_str(), reason);
+		close();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief True once the creator of a shared segment has written the magic (it goes last).
+ */
+static bool shared_published(const void* base) {
+	const volatile char* magic = static_cast<const volatile char*>(base);
+	for (int i = 0; i < 8; i++)
+		if (magic[i] != WEIGHT_FILE_MAGIC[i]) return false;
+	return true;
+}
+
+#ifndef _WIN32
+/**
+ * @brief Maps a segment another process created, once it has its full size and is published.
+ * * The creator holds an exclusive flock() while it fills the segment; the kernel drops the
+ * * lock if it dies, so an unpublished segment nobody holds is reported as 'abandoned'.
+ * @return The read-only mapping, or nullptr on timeout or abandonment.
+ */
+static void* attach_shared(int fd, size_t size, bool& abandoned) {
+	void* base = nullptr;
+	auto map_when_sized = [&]() {
+		// Mapping before ftruncate has run would fault (SIGBUS) on the first read
+		struct stat st;
+		if (base || fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != size) return;
+		base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (base == MAP_FAILED) base = nullptr;
+	};
+
+	abandoned = false;
+	for (int waited = 0; waited < WeightFile::SHARED_ATTACH_TIMEOUT_MS; waited++) {
+		map_when_sized();
+		if (base && shared_published(base)) return base;
+
+		// Nobody filling it: re-check under the lock (the creator may just have published)
+		if (flock(fd, LOCK_SH | LOCK_NB) == 0) {
+			map_when_sized();
+			const bool published = base && shared_published(base);
+			flock(fd, LOCK_UN);
+			if (published) return base;
+			abandoned = true;
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	if (base) munmap(base, size);
+	return nullptr;
+}
+#endif
+
+bool WeightFile::open_shared(const std::string& name, const Filler& fill) {
+	close();
+	const size_t size = sizeof(WeightFileHeader) + sizeof(InferenceWeights);
+
+	// 1. Create the segment, or open the one another process created
+	bool creator = true;
+	void* base = nullptr;
+#ifdef _WIN32
+	mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+								 static_cast<DWORD>(size), name.c_str());
+	if (mapping) {
+		creator = GetLastError() != ERROR_ALREADY_EXISTS;
+		base = MapViewOfFile(mapping, creator ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+	}
+#else
+	// An abandoned segment is unlinked and created again (once)
+	int creator_fd = -1;
+	for (int attempt = 0; attempt < 2 && !base; attempt++) {
+		int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+		creator = fd >= 0;
+		if (creator) {
+			flock(fd, LOCK_EX);	 // Held until the header is published (see attach_shared)
+			if (ftruncate(fd, size) == 0) {
+				base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				if (base == MAP_FAILED) base = nullptr;
+			}
+			if (base) {
+				creator_fd = fd;
+			} else {
+				::close(fd);
+				shm_unlink(name.c_str());
+			}
+			break;
+		}
+		if (errno != EEXIST) break;
+
+		fd = shm_open(name.c_str(), O_RDONLY, 0);
+		if (fd < 0) continue;  // Unlinked in the meantime: try to create it
+		bool abandoned;
+		base = attach_shared(fd, size, abandoned);
+		::close(fd);
+		if (abandoned) {
+			fprintf(stderr, "%s: creating process died, recreating the segment\n", name.c_str());
+			shm_unlink(name.c_str());
+		} else if (!base) {
+			fprintf(stderr, "%s: timed out waiting for the creating process\n", name.c_str());
+			break;
+		}
+	}
+#endif
+	header = static_cast<const WeightFileHeader*>(base);
+	mapped_size = size;
+	if (!header) {
+		fprintf(stderr, "%s: cannot map shared segment\n", name.c_str());
+		close();
+		return false;
+	}
+
+	if (creator) {
+		// 2a. Fill the tables, then publish the header with the magic written last
+		char* bytes = static_cast<char*>(base);
+		InferenceWeights* w = new (bytes + sizeof(WeightFileHeader)) InferenceWeights;
+		uint32_t trained_mask = 0;
+		if (!fill(*w, trained_mask)) {
+			close();
+#ifndef _WIN32
+			shm_unlink(name.c_str());
+			::close(creator_fd);
+#endif
+			return false;
+		}
+		WeightFileHeader h = make_header(*w, trained_mask);
+		memcpy(bytes + sizeof(h.magic), reinterpret_cast<const char*>(&h) + sizeof(h.magic),
+			   sizeof(h) - sizeof(h.magic));
+		std::atomic_thread_fence(std::memory_order_release);
+		memcpy(bytes, h.magic, sizeof(h.magic));
+#ifndef _WIN32
+		mprotect(base, size, PROT_READ);  // Attach read-only like everyone else
+		::close(creator_fd);			  // Releases the flock
+#endif
+	} else {
+		// 2b. Wait for the creator to publish (POSIX attach_shared already has)
+		for (int waited = 0; !shared_published(base); waited++) {
+			if (waited >= SHARED_ATTACH_TIMEOUT_MS) {
+				fprintf(stderr, "%s: timed out waiting for the creating process\n", name.c_str());
+				close();
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+	return validate(name);
+}
+
+void WeightFile::close() {
+#ifdef _WIN32
+	if (header) UnmapViewOfFile(header);
+	if (mapping) CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+	mapping = nullptr;
+	file = INVALID_HANDLE_VALUE;
+#else
+	if (header) munmap(const_cast<WeightFileHeader*>(header), mapped_size);
+#endif
+	header = nullptr;
+	mapped_size = 0;
+}
+
+bool WeightFile::verify(int t) const {
+	return fnv1a(weights().table(t), InferenceWeights::TABLE_SIZE * sizeof(float)) ==
+		   header->table_checksum[t];
+}
@@ -36,7 +36,6 @@
 
 /// @name N-Tuple Network Constants
 /// @{
-#define POS_NUM 1537019	 ///< Total number of position encodings for 4-tuple patterns
 #define FEATURE_NUM 256	 ///< Total feature size per pattern
 #define TUPLE_NUM 61	 ///< Total number of defined 4-tuple patterns
 /// @}
@@ -51,21 +50,28 @@
 #include <time.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <climits>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <streambuf>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
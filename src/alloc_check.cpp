@@ -0,0 +1,140 @@
+/**
+ * @file alloc_check.cpp
+ * @brief Checks that a warmed-up ISMCTS search makes no heap allocations.
+ * * Run from src/server/ (the weight and position paths are relative). 4T_GST.hpp and
+ * * ismcts.hpp befriend 'int main()', so the options come from the environment:
+ * *   ALLOC_POSITIONS=file    saved positions (default ./data/quant_positions.txt)
+ * *   ALLOC_LIMIT=N           first N positions of the file (default 16)
+ * *   ALLOC_SIMULATIONS=S     iterations per findBestMove (default 2000)
+ * *   ALLOC_THREADS=T         threads / rollouts of the parallel modes (default 4)
+ * * The global operator new / delete are replaced by counting versions. Each search mode
+ * * (sequential, root-, tree- and leaf-parallel) gets one ISMCTS object, which searches
+ * * every position twice: a warm-up search with 2S iterations sizes the node pools, the
+ * * worker arenas and the scratch buffers, and the repeat search with S iterations must not
+ * * allocate. (Tree-parallel trees differ from run to run; the larger warm-up covers that.)
+ * * Any allocation in a repeat search is reported and the exit code is 1.
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#include "4T_GST.hpp"
+#include "4T_WEIGHTS.hpp"
+#include "4T_header.h"
+#include "ismcts.hpp"
+#include "tool_common.hpp"
+
+#if LUT_MIRROR
+#define WEIGHT_FILE "./data/weights_500000_mirror.bin"
+#else
+#define WEIGHT_FILE "./data/weights_500000.bin"
+#endif
+
+/// Seed of the search and policy RNGs (the same for both searches of a position)
+static const uint32_t SEED = 20260601;
+
+struct SearchMode {
+	const char* name;
+	bool parallel;		///< Use ALLOC_THREADS search threads
+	ParallelMode mode;	///< Root or tree parallelization (parallel modes only)
+	bool leaf;			///< Use ALLOC_THREADS rollouts per leaf
+};
+
+static const SearchMode MODES[] = {{"sequential", false, ParallelMode::Root, false},
+								   {"root-parallel", true, ParallelMode::Root, false},
+								   {"tree-parallel", true, ParallelMode::Tree, false},
+								   {"leaf-parallel", false, ParallelMode::Root, true}};
+
+/// Calls to operator new / new[] since start-up
+static std::atomic<long> allocations(0);
+
+// Out of line: GCC flags an inlined new paired with free() (-Wmismatched-new-delete)
+#ifdef __GNUC__
+#define ALLOC_NOINLINE __attribute__((noinline))
+#else
+#define ALLOC_NOINLINE
+#endif
+
+ALLOC_NOINLINE void* operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+ALLOC_NOINLINE void* operator new[](size_t size) { return operator new(size); }
+ALLOC_NOINLINE void operator delete(void* p) noexcept { free(p); }
+ALLOC_NOINLINE void operator delete[](void* p) noexcept { free(p); }
+ALLOC_NOINLINE void operator delete(void* p, size_t) noexcept { free(p); }
+ALLOC_NOINLINE void operator delete[](void* p, size_t) noexcept { free(p); }
+
+/**
+ * @brief Integer option from the environment, 'fallback' when unset.
+ */
+static int env_int(const char* name, int fallback) {
+	const char* value = getenv(name);
+	return value ? atoi(value) : fallback;
+}
+
+int main() {
+	const char* env_path = getenv("ALLOC_POSITIONS");
+	const std::string path = env_path ? env_path : "./data/quant_positions.txt";
+	const int limit = env_int("ALLOC_LIMIT", 16);
+	const int simulations = std::max(1, env_int("ALLOC_SIMULATIONS", 2000));
+	const int threads = std::max(2, env_int("ALLOC_THREADS", 4));
+	if (!freopen(NULL_DEVICE, "r", stdin)) return 1;  // print_board waits for a key press
+
+	// 1. Weights as the server loads them: the binary file, else the CSVs
+	static WeightFile weight_file;
+	static InferenceWeights csv_weights;
+	const InferenceWeights* weights = nullptr;
+	if (weight_file.open(WEIGHT_FILE)) weights = &weight_file.weights();
+	if (!weights && csv_weights.read_data_file(500000)) weights = &csv_weights;
+	if (!weights) {
+		fprintf(stderr, "standard tables for 500000 not found\n");
+		return 1;
+	}
+#if LUT_QUANT_BITS
+	static QuantizedWeights quantized(*weights);
+	const EvalWeights& d = quantized;
+#else
+	const EvalWeights& d = *weights;
+#endif
+
+	std::vector<std::string> lines = read_positions(path);
+	if (static_cast<int>(lines.size()) > limit) lines.resize(limit);
+	if (lines.empty()) {
+		fprintf(stderr, "%s: no positions\n", path.c_str());
+		return 1;
+	}
+	std::vector<GST> positions(lines.size());
+	for (size_t i = 0; i < lines.size(); i++) load_position(positions[i], lines[i]);
+
+	// 2. Warm-up and repeat search of every position (the search log on stderr is silenced)
+	printf("Allocation check: %zu positions (%s), %d simulations per search, %d threads\n",
+		   positions.size(), path.c_str(), simulations, threads);
+	printf("  %-14s %10s %10s %10s\n", "mode", "warm-up", "repeat", "per iter");
+	long total = 0;
+	for (const SearchMode& mode : MODES) {
+		ISMCTS search(simulations, mode.parallel ? threads : 1);
+		search.setParallelMode(mode.mode);
+		if (mode.leaf) search.setLeafParallel(threads);
+
+		long counts[2] = {0, 0};
+		{
+			QuietStdout quiet(2);
+			for (size_t i = 0; i < positions.size(); i++) {
+				for (int pass = 0; pass < 2; pass++) {
+					search.simulations = pass ? simulations : 2 * simulations;
+					search.rng.seed(SEED + i);
+					GST::seed_policy(SEED + i);	 // A single-thread search plays on this thread
+					GST game = positions[i];
+					const long before = allocations.load();
+					search.findBestMove(game, d);
+					counts[pass] += allocations.load() - before;
+				}
+			}
+		}
+		printf("  %-14s %10ld %10ld %10.4f\n", mode.name, counts[0], counts[1],
+			   static_cast<double>(counts[1]) / (simulations * positions.size()));
+		total += counts[1];
+	}
+	printf("%s\n", total ? "HEAP ALLOCATIONS AFTER WARM-UP" : "No heap allocations after warm-up");
+	return total ? 1 : 0;
+}
@@ -0,0 +1,341 @@
+/**
+ * @file bench.cpp
+ * @brief Micro-benchmarks of the engine hot paths, with per-sample spread and a JSON report.
+ * * Run from src/server/ (the weight and position paths are relative). 4T_GST.hpp and
+ * * ismcts.hpp befriend 'int main()', so the options come from the environment:
+ * *   BENCH_POSITIONS=file       saved positions (default ./data/quant_positions.txt)
+ * *   BENCH_LIMIT=N              first N positions of the file (default 256)
+ * *   BENCH_SAMPLES=R            timed samples per benchmark, after one warm-up (default 10)
+ * *   BENCH_PASSES=P             passes over the positions per sample (default 20)
+ * *   BENCH_SIMULATIONS=a,b,...  findBestMove iteration counts (default 100,1000,10000)
+ * *   BENCH_SEARCHES=N           positions searched per findBestMove sample (default 4)
+ * *   BENCH_JSON=file            also write the results there as JSON
+ * *   BENCH_LABEL=text           free-form tag copied into the JSON (e.g. the commit)
+ * * Every sample repeats the same work: the positions are determinized once from a fixed
+ * * seed, and the policy and search RNGs are reseeded before each sample. A benchmark's
+ * * ns/op is the sample's timed nanoseconds over its operation count; the report gives the
+ * * mean, standard deviation, min and max of that over the samples. Setup between the timed
+ * * sections (copies, determinizations, search trees) is not counted.
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#include "4T_GST.hpp"
+#include "4T_WEIGHTS.hpp"
+#include "4T_header.h"
+#include "ismcts.hpp"
+#include "tool_common.hpp"
+
+#if LUT_MIRROR
+#define WEIGHT_FILE "./data/weights_500000_mirror.bin"
+#else
+#define WEIGHT_FILE "./data/weights_500000.bin"
+#endif
+
+/// Seed of the determinizations, the policy RNG and the search RNGs
+static const uint32_t SEED = 20260601;
+
+/// Indexed by GST_ARRAY / GST_BITBOARD
+static const char* BACKEND_NAMES[] = {"array", "bitboard"};
+
+/// Results are accumulated here so the timed calls cannot be optimized away
+static volatile double sink;
+
+struct Sample {
+	long ops = 0;	  ///< Operations timed
+	double ns = 0.0;  ///< Nanoseconds they took
+};
+
+struct BenchResult {
+	std::string name;
+	long ops;				  ///< Operations per sample
+	std::vector<double> ns;	  ///< ns/op of every sample
+	double mean, stddev, min, max;
+};
+
+/**
+ * @brief Nanoseconds elapsed since t0.
+ */
+static double ns_since(std::chrono::steady_clock::time_point t0) {
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * @brief Runs 'sample' once to warm up, then 'samples' times, and prints the summary row.
+ */
+template <class F>
+static BenchResult measure(const std::string& name, int samples, F sample) {
+	BenchResult result{name, 0, {}, 0.0, 0.0, 0.0, 0.0};
+	sample();  // Caches, branch predictors, first touch of the node pools
+	for (int r = 0; r < samples; r++) {
+		const Sample s = sample();
+		result.ops = s.ops;
+		result.ns.push_back(s.ns / std::max(1L, s.ops));
+	}
+
+	const double n = static_cast<double>(result.ns.size());
+	double sum = 0.0, squares = 0.0;
+	for (double x : result.ns) sum += x;
+	result.mean = sum / n;
+	for (double x : result.ns) squares += (x - result.mean) * (x - result.mean);
+	result.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+	result.min = *std::min_element(result.ns.begin(), result.ns.end());
+	result.max = *std::max_element(result.ns.begin(), result.ns.end());
+
+	printf("  %-34s %10ld %14.1f %12.1f %6.1f%% %14.1f %14.1f\n", name.c_str(), result.ops,
+		   result.mean, result.stddev, 100.0 * result.stddev / result.mean, result.min,
+		   result.max);
+	fflush(stdout);
+	return result;
+}
+
+/**
+ * @brief 'text' as a JSON string literal.
+ */
+static std::string json_string(const std::string& text) {
+	std::string out = "\"";
+	for (char c : text) {
+		if (c == '"' || c == '\\') out += '\\';
+		if (static_cast<unsigned char>(c) >= 0x20) out += c;
+	}
+	return out + "\"";
+}
+
+/**
+ * @brief Writes the configuration and every result to 'path'.
+ */
+static bool write_json(const std::string& path, const std::string& config,
+					   const std::vector<BenchResult>& results) {
+	FILE* out = fopen(path.c_str(), "w");
+	if (!out) return false;
+	fprintf(out, "{\n  \"config\": %s,\n  \"results\": [\n", config.c_str());
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult& r = results[i];
+		fprintf(out,
+				"    {\"name\": %s, \"ops\": %ld, \"mean_ns\": %.3f, \"stddev_ns\": %.3f, "
+				"\"min_ns\": %.3f, \"max_ns\": %.3f, \"samples_ns\": [",
+				json_string(r.name).c_str(), r.ops, r.mean, r.stddev, r.min, r.max);
+		for (size_t k = 0; k < r.ns.size(); k++) fprintf(out, "%s%.3f", k ? ", " : "", r.ns[k]);
+		fprintf(out, "]}%s\n", i + 1 < results.size() ? "," : "");
+	}
+	fprintf(out, "  ]\n}\n");
+	fclose(out);
+	return true;
+}
+
+/**
+ * @brief Integer option from the environment, 'fallback' when unset.
+ */
+static int env_int(const char* name, int fallback) {
+	const char* value = getenv(name);
+	return value ? atoi(value) : fallback;
+}
+
+int main() {
+	const char* env_path = getenv("BENCH_POSITIONS");
+	const char* env_sims = getenv("BENCH_SIMULATIONS");
+	const char* env_json = getenv("BENCH_JSON");
+	const char* env_label = getenv("BENCH_LABEL");
+	const std::string path = env_path ? env_path : "./data/quant_positions.txt";
+	const int limit = env_int("BENCH_LIMIT", 256);
+	const int samples = std::max(1, env_int("BENCH_SAMPLES", 10));
+	const int passes = std::max(1, env_int("BENCH_PASSES", 20));
+	const int searches = std::max(1, env_int("BENCH_SEARCHES", 4));
+	std::vector<int> simulation_counts;
+	std::stringstream sims(env_sims ? env_sims : "100,1000,10000");
+	for (std::string item; std::getline(sims, item, ',');)
+		if (atoi(item.c_str()) > 0) simulation_counts.push_back(atoi(item.c_str()));
+	if (!freopen(NULL_DEVICE, "r", stdin)) return 1;  // print_board waits for a key press
+
+	// 1. Weights as the server loads them: the binary file, else the CSVs
+	static WeightFile weight_file;
+	static InferenceWeights csv_weights;
+	const InferenceWeights* weights = nullptr;
+	if (weight_file.open(WEIGHT_FILE)) weights = &weight_file.weights();
+	if (!weights && csv_weights.read_data_file(500000)) weights = &csv_weights;
+	if (!weights) {
+		fprintf(stderr, "standard tables for 500000 not found\n");
+		return 1;
+	}
+#if LUT_QUANT_BITS
+	static QuantizedWeights quantized(*weights);
+	const EvalWeights& d = quantized;
+#else
+	const EvalWeights& d = *weights;
+#endif
+
+	// 2. Positions as the server sees them (search inputs) and one determinization of each
+	std::vector<std::string> lines = read_positions(path);
+	if (static_cast<int>(lines.size()) > limit) lines.resize(limit);
+	if (lines.empty()) {
+		fprintf(stderr, "%s: no positions\n", path.c_str());
+		return 1;
+	}
+	std::vector<GST> positions(lines.size());
+	for (size_t i = 0; i < lines.size(); i++) load_position(positions[i], lines[i]);
+
+	ISMCTS is(1);
+	is.rng.seed(SEED);
+	std::vector<GST> determinized = positions;
+	for (GST& game : determinized) {
+		is.prepareArrangements(game);
+		is.randomizeUnrevealedPieces(game, false);
+	}
+	const long count = static_cast<long>(positions.size());
+
+	printf("Bench: GST_BACKEND %s, %s LUTs, %ld positions (%s), %d samples, %d passes\n",
+		   BACKEND_NAMES[GST_BACKEND],
+		   LUT_QUANT_BITS ? (LUT_QUANT_BITS == 8 ? "8-bit" : "16-bit") : "float", count,
+		   path.c_str(), samples, passes);
+	printf("  %-34s %10s %14s %12s %7s %14s %14s\n", "benchmark", "ops", "mean ns/op", "stddev",
+		   "cv", "min", "max");
+	std::vector<BenchResult> results;
+
+	// 3. GST: move generation, make / unmake, evaluation, rollout policy
+	for (int backend : {GST_ARRAY, GST_BITBOARD}) {
+		if (!GST::has_backend(backend)) continue;
+		results.push_back(measure(std::string("gen_all_move/") + BACKEND_NAMES[backend], samples,
+								  [&]() {
+									  Sample s;
+									  int moves[MAX_MOVES];
+									  long total = 0;
+									  auto t0 = std::chrono::steady_clock::now();
+									  for (int p = 0; p < passes; p++)
+										  for (GST& game : determinized)
+											  total += game.gen_all_move_with(backend, moves);
+									  s.ns = ns_since(t0);
+									  s.ops = passes * count;
+									  sink = sink + total;
+									  return s;
+								  }));
+	}
+
+	std::vector<std::vector<int>> legal(determinized.size());
+	long legal_moves = 0;
+	for (size_t i = 0; i < determinized.size(); i++) {
+		int moves[MAX_MOVES];
+		legal[i].assign(moves, moves + determinized[i].gen_all_move(moves));
+		legal_moves += legal[i].size();
+	}
+	results.push_back(measure("do_move+undo", samples, [&]() {
+		Sample s;
+		auto t0 = std::chrono::steady_clock::now();
+		for (int p = 0; p < passes; p++) {
+			for (size_t i = 0; i < determinized.size(); i++) {
+				for (int move : legal[i]) {
+					determinized[i].do_move(move);
+					determinized[i].undo();
+				}
+			}
+		}
+		s.ns = ns_since(t0);
+		s.ops = passes * legal_moves;
+		return s;
+	}));
+
+	results.push_back(measure("compute_board_weight", samples, [&]() {
+		Sample s;
+		double total = 0.0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (int p = 0; p < passes; p++)
+			for (GST& game : determinized) total += game.compute_board_weight(d);
+		s.ns = ns_since(t0);
+		s.ops = passes * count;
+		sink = sink + total;
+		return s;
+	}));
+
+	results.push_back(measure("highest_weight", samples, [&]() {
+		Sample s;
+		long total = 0;
+		GST::seed_policy(SEED);
+		auto t0 = std::chrono::steady_clock::now();
+		for (int p = 0; p < passes; p++)
+			for (GST& game : determinized) total += game.highest_weight(d);
+		s.ns = ns_since(t0);
+		s.ops = passes * count;
+		sink = sink + total;
+		return s;
+	}));
+
+	// 4. ISMCTS phases: determinization (plain and weighted) and one rollout
+	for (bool use_stats : {false, true}) {
+		const char* name =
+			use_stats ? "randomizeUnrevealedPieces/stats" : "randomizeUnrevealedPieces";
+		results.push_back(measure(name, samples, [&]() {
+			Sample s;
+			is.rng.seed(SEED);
+			for (const GST& info : positions) {
+				GST state = info;
+				is.prepareArrangements(info);
+				auto t0 = std::chrono::steady_clock::now();
+				for (int p = 0; p < passes; p++) is.randomizeUnrevealedPieces(state, use_stats);
+				s.ns += ns_since(t0);
+				s.ops += passes;
+			}
+			return s;
+		}));
+	}
+
+	results.push_back(measure("simulation", samples, [&]() {
+		Sample s;
+		double total = 0.0;
+		is.rng.seed(SEED);
+		std::mt19937 gen(SEED);
+		GST::seed_policy(SEED);
+		for (const GST& info : positions) {
+			GST state = info;
+			const int plies = state.get_nplies();
+			is.prepareArrangements(info);
+			for (int p = 0; p < passes; p++) {
+				is.randomizeUnrevealedPieces(state, false);
+				auto t0 = std::chrono::steady_clock::now();
+				total += is.simulation(state, d, USER, gen);
+				state.undo_to(plies);
+				s.ns += ns_since(t0);
+				s.ops++;
+			}
+		}
+		sink = sink + total;
+		return s;
+	}));
+
+	// 5. Whole searches (single thread; the search log on stderr is silenced)
+	const int searched = std::min(searches, static_cast<int>(positions.size()));
+	for (int simulations : simulation_counts) {
+		results.push_back(
+			measure("findBestMove/" + std::to_string(simulations), samples, [&]() {
+				Sample s;
+				long total = 0;
+				QuietStdout quiet(2);
+				for (int i = 0; i < searched; i++) {
+					ISMCTS search(simulations);
+					search.rng.seed(SEED + i);
+					GST::seed_policy(SEED + i);	 // A single-thread search plays on this thread
+					GST game = positions[i];
+					auto t0 = std::chrono::steady_clock::now();
+					total += search.findBestMove(game, d);
+					s.ns += ns_since(t0);
+					s.ops++;
+				}
+				sink = sink + total;
+				return s;
+			}));
+	}
+
+	if (env_json) {
+		std::stringstream config;
+		config << "{\"label\": " << json_string(env_label ? env_label : "")
+			   << ", \"gst_backend\": " << json_string(BACKEND_NAMES[GST_BACKEND])
+			   << ", \"lut_quant_bits\": " << LUT_QUANT_BITS << ", \"lut_mirror\": " << LUT_MIRROR
+			   << ", \"compiler\": " << json_string(__VERSION__)
+			   << ", \"positions_file\": " << json_string(path) << ", \"positions\": " << count
+			   << ", \"samples\": " << samples << ", \"passes\": " << passes
+			   << ", \"searches\": " << searched << ", \"seed\": " << SEED << "}";
+		if (!write_json(env_json, config.str(), results)) {
+			fprintf(stderr, "%s: cannot write\n", env_json);
+			return 1;
+		}
+		printf("Wrote %s\n", env_json);
+	}
+	return 0;
+}
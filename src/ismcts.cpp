@@ -7,8 +7,35 @@
 
 #include "ismcts.hpp"
 
-// Definition of static constant
+// Definition of static constants
 constexpr int ISMCTS::dir_val[4];
+constexpr int ISMCTS::VIRTUAL_LOSS;
+constexpr int ISMCTS::MAX_LEAF_ROLLOUTS;
+constexpr int ISMCTS::TIME_CHECK_INTERVAL;
+constexpr int ISMCTS::MAX_ARRANGEMENTS;
+constexpr int ISMCTS::MIN_FRESH_DIVISOR;
+constexpr int ISMCTS::GAME_PLY_LIMIT;
+constexpr int ISMCTS::MIN_MOVES_LEFT;
+constexpr int ISMCTS::TIME_RESERVE_MS;
+constexpr int ISMCTS::MIN_MOVE_TIME_MS;
+
+namespace {
+
+/**
+ * @brief Pascal's triangle up to PIECES, for combinatorial-number-system ranks.
+ */
+struct BinomialTable {
+	int c[PIECES + 1][PIECES + 1];
+	constexpr BinomialTable() : c() {
+		for (int n = 0; n <= PIECES; n++) {
+			c[n][0] = 1;
+			for (int k = 1; k <= n; k++) c[n][k] = c[n - 1][k - 1] + (k < n ? c[n - 1][k] : 0);
+		}
+	}
+};
+constexpr BinomialTable BINOM;
+
+}  // namespace
 
 // =============================
 // Constructor & Lifecycle
@@ -17,155 +44,202 @@ constexpr int ISMCTS::dir_val[4];
 /**
  * @brief Construct a new ISMCTS object and seed the RNG.
  */
-ISMCTS::ISMCTS(int simulations) : simulations(simulations) {
+ISMCTS::ISMCTS(int simulations, int num_threads)
+	: simulations(simulations),
+	  num_threads(std::max(1, num_threads)),
+	  parallel_mode(ParallelMode::Root),
+	  vloss(0),
+	  root(nullptr),
+	  pool(new NodePool()),
+	  reuse_tree(false),
+	  last_move(-1),
+	  stop_search(false),
+	  pondered(false),
+	  timed(false),
+	  leaf_rollouts(1) {
+	tree_pool = pool.get();
+	arrangement_count = 0;
 	auto seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 	rng.seed(static_cast<unsigned int>(seed));
+	setThreads(num_threads);
+}
+
+/**
+ * @brief Joins the pondering thread so it never outlives the tree.
+ */
+ISMCTS::~ISMCTS() { stopPondering(); }
+
+/**
+ * @brief Sets the number of root-parallel workers for subsequent searches.
+ * * Workers and pool threads are built once here, so a search only rewinds them.
+ */
+void ISMCTS::setThreads(int num_threads) {
+	this->num_threads = std::max(1, num_threads);
+	const int count = this->num_threads > 1 ? this->num_threads : 0;
+	while (static_cast<int>(workers.size()) < count) workers.emplace_back(new ISMCTS(simulations));
+	workers.resize(count);
+	worker_seeds.resize(count);
+	if (!count)
+		worker_pool.reset();
+	else if (!worker_pool || worker_pool->size() != count)
+		worker_pool.reset(new ThreadPool(count - 1));
+}
+
+/**
+ * @brief Selects root or tree parallelization for subsequent searches.
+ */
+void ISMCTS::setParallelMode(ParallelMode mode) { parallel_mode = mode; }
+
+/**
+ * @brief Configures leaf-parallel rollouts and (re)creates the rollout thread pool.
+ */
+void ISMCTS::setLeafParallel(int rollouts, int threads) {
+	leaf_rollouts = std::max(1, std::min(rollouts, MAX_LEAF_ROLLOUTS));
+	if (threads <= 0) threads = leaf_rollouts;
+	threads = std::min(threads, leaf_rollouts);
+
+	leaf_pool.reset(leaf_rollouts > 1 ? new ThreadPool(threads - 1) : nullptr);
+	leaf_rngs.resize(leaf_rollouts);
+	leaf_policies.resize(leaf_rollouts);
+	leaf_states.resize(leaf_rollouts);
+	seedLeafRollouts();
+}
+
+/**
+ * @brief Draws fresh rollout and policy seeds for every leaf slot from this object's RNG.
+ */
+void ISMCTS::seedLeafRollouts() {
+	for (int i = 0; i < leaf_rollouts; i++) {
+		leaf_rngs[i].seed(rng());
+		leaf_policies[i].seed(rng());
+	}
+}
+
+/**
+ * @brief Enables or disables keeping the tree between searches.
+ */
+void ISMCTS::setTreeReuse(bool enable) {
+	reuse_tree = enable;
+	last_move = -1;
 }
 
 /**
  * @brief Resets the ISMCTS state, clearing the tree and statistical data.
  */
 void ISMCTS::reset() {
+	stopPondering();
 	auto seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 	rng.seed(static_cast<unsigned int>(seed));
 
-	Node::cleanup(root);
-	arrangement_stats.clear();
+	pool->reset();
+	root = nullptr;
+	arrangement_count = 0;
+	last_move = -1;
+	pondered = false;
 }
 
 // =============================
 // Determinization Strategy
 // =============================
 
-/**
- * @brief Creates a concrete game state (determinization) from the information set.
- * * Calls randomizeUnrevealedPieces to guess hidden information.
- */
-GST ISMCTS::getDeterminizedState(const GST& originalState, int current_iteration) {
-	GST determinizedState = originalState;
-	randomizeUnrevealedPieces(determinizedState, current_iteration);
-	return determinizedState;
-}
-
 /**
  * @brief Randomizes the colors of unrevealed pieces.
  * * Strategy:
  * * - Early iterations: Pure random shuffling.
  * * - Later iterations: Weighted random based on historical win rates (Inference).
  */
-void ISMCTS::randomizeUnrevealedPieces(GST& state, int current_iteration) {
-	const bool* revealed = state.get_revealed();
-	std::vector<int> unrevealed_pieces;
-	int redCount = 0, blueCount = 0;
-
-	// 1. Identify all unrevealed pieces and count revealed colors
-	for (int i = PIECES; i < PIECES * 2; i++) {
-		if (revealed[i]) {
-			if (state.get_color(i) == -RED)
-				redCount++;
-			else
-				blueCount++;
-		} else {
-			unrevealed_pieces.push_back(i);
-		}
-	}
-
-	int totalRed = 4;
-	int totalBlue = 4;
-	int redRemaining = totalRed - redCount;
-	int blueRemaining = totalBlue - blueCount;
-
-	if (unrevealed_pieces.empty()) return;
-
-	// 2. Decide strategy based on iteration count
-	// Use inference stats only in the latter half of simulations
-	bool use_stats = (current_iteration >= simulations / 2);
+void ISMCTS::randomizeUnrevealedPieces(GST& state, bool use_stats) {
+	// The hidden pieces and their red count were fixed by prepareArrangements()
+	if (hidden_count == 0) return;
 
+	// Decide strategy (the caller enables inference stats in the latter half of the search)
 	if (!use_stats) {
 		// Strategy A: Pure Random Shuffle
-		std::shuffle(unrevealed_pieces.begin(), unrevealed_pieces.end(), rng);
-		for (size_t i = 0; i < unrevealed_pieces.size(); i++) {
-			int piece = unrevealed_pieces[i];
-			if (i < redRemaining) {
-				state.set_color(piece, -RED);
-			} else {
-				state.set_color(piece, -BLUE);
-			}
+		int unrevealed_pieces[PIECES];
+		std::copy(hidden_pieces, hidden_pieces + hidden_count, unrevealed_pieces);
+		std::shuffle(unrevealed_pieces, unrevealed_pieces + hidden_count, rng);
+		for (int i = 0; i < hidden_count; i++) {
+			state.set_color(unrevealed_pieces[i], i < hidden_red ? -RED : -BLUE);
 		}
 		return;
 	}
 
 	// Strategy B: Inference-based Weighted Shuffle
-	// Generate all valid arrangements of remaining pieces
-	std::vector<std::vector<int>> arrangements;
-	int total_pieces = redRemaining + blueRemaining;
-	int total_combinations = 1 << total_pieces;
-
-	for (int mask = 0; mask < total_combinations; mask++) {
-		std::vector<int> arrangement;
-		int red = 0, blue = 0;
-		for (int i = 0; i < total_pieces; i++) {
-			if (mask & (1 << i)) {
-				arrangement.push_back(-RED);
-				red++;
-			} else {
-				arrangement.push_back(-BLUE);
-				blue++;
-			}
-		}
-		if (red == redRemaining && blue == blueRemaining) {
-			arrangements.push_back(arrangement);
-		}
+	// The cumulative table only moves noticeably once every arrangement may have gained a
+	// sample, so it is rebuilt after arrangement_count updates rather than per iteration
+	if (stats_since_cdf < 0 || stats_since_cdf >= arrangement_count) rebuildArrangementCdf();
+
+	// Select an arrangement using weighted random distribution
+	std::uniform_real_distribution<> dist(0.0, 1.0);
+	double r = dist(rng) * arrangement_cdf[arrangement_count - 1];
+	int selected_idx = std::lower_bound(arrangement_cdf, arrangement_cdf + arrangement_count, r) -
+					   arrangement_cdf;
+	selected_idx = std::min(selected_idx, arrangement_count - 1);
+
+	// Apply the selected arrangement to the state
+	const int selected = arrangement_masks[selected_idx];
+	for (int i = 0; i < hidden_count; i++) {
+		state.set_color(hidden_pieces[i], (selected >> i & 1) ? -RED : -BLUE);
 	}
+}
 
-	// Calculate win probability for each arrangement
-	std::vector<double> win_rates;
-	for (const auto& arrangement : arrangements) {
-		std::string key;
-		for (auto color : arrangement) {
-			key += (color == -RED) ? 'R' : 'B';
-		}
+/**
+ * @brief Lists every red/blue assignment of the hidden pieces, stored by rank.
+ */
+void ISMCTS::prepareArrangements(const GST& info) {
+	const bool* revealed = info.get_revealed();
+	int redCount = 0;
 
-		auto it = arrangement_stats.find(key);
-		if (it == arrangement_stats.end() || it->second.second == 0) {
-			win_rates.push_back(0.5);  // Default to 50% if no data
+	// 1. Identify all unrevealed pieces and count revealed colors
+	hidden_count = 0;
+	for (int i = PIECES; i < PIECES * 2; i++) {
+		if (revealed[i]) {
+			if (info.get_color(i) == -RED) redCount++;
 		} else {
-			double win_rate = static_cast<double>(it->second.first) / it->second.second;
-			win_rates.push_back(win_rate);
+			hidden_pieces[hidden_count++] = i;
 		}
 	}
-
-	// Calculate selection weights (inverse win rate logic to find harder scenarios?)
-	std::vector<double> weights;
-	double total_weight = 0.0;
-	for (double rate : win_rates) {
-		double weight = 1.0 - rate + 0.05;	// Add bias
-		weights.push_back(weight);
-		total_weight += weight;
+	hidden_red = std::max(0, std::min(4 - redCount, hidden_count));
+
+	// 2. Enumerate the masks with exactly hidden_red bits; the rank is a perfect index
+	arrangement_count = BINOM.c[hidden_count][hidden_red];
+	for (int mask = 0; mask < 1 << hidden_count; mask++) {
+		if (__builtin_popcount(mask) != hidden_red) continue;
+		int rank = 0, k = 0;
+		for (int bit = 0; bit < hidden_count; bit++)
+			if (mask >> bit & 1) rank += BINOM.c[bit][++k];
+		arrangement_masks[rank] = static_cast<uint8_t>(mask);
 	}
 
-	for (auto& w : weights) {
-		w /= total_weight;
-	}
+	std::fill(arrangement_stats, arrangement_stats + MAX_ARRANGEMENTS, std::make_pair(0, 0));
+	stats_since_cdf = -1;
+}
 
-	// Select an arrangement using weighted random distribution
-	std::uniform_real_distribution<> dist(0.0, 1.0);
-	double r = dist(rng);
-	double cumulative = 0.0;
-	int selected_idx = 0;
-	for (size_t i = 0; i < weights.size(); i++) {
-		cumulative += weights[i];
-		if (r <= cumulative) {
-			selected_idx = i;
-			break;
-		}
-	}
+/**
+ * @brief Ranks the red subset of hidden_pieces: sum of C(position, i) over its i-th member.
+ */
+int ISMCTS::arrangementRank(const GST& state) const {
+	int rank = 0, k = 0;
+	for (int i = 0; i < hidden_count; i++)
+		if (state.get_color(hidden_pieces[i]) == -RED) rank += BINOM.c[i][++k];
+	return rank;
+}
 
-	// Apply the selected arrangement to the state
-	const auto& selected_arrangement = arrangements[selected_idx];
-	for (size_t i = 0; i < unrevealed_pieces.size(); i++) {
-		state.set_color(unrevealed_pieces[i], selected_arrangement[i]);
+/**
+ * @brief Turns win rates into cumulative sampling weights.
+ * * Weight = 1 - win rate + 0.05: arrangements we do badly against are sampled more
+ * * (unseen ones count as 50%).
+ */
+void ISMCTS::rebuildArrangementCdf() {
+	double cumulative = 0.0;
+	for (int a = 0; a < arrangement_count; a++) {
+		const auto& stats = arrangement_stats[a];
+		double rate =
+			stats.second == 0 ? 0.5 : static_cast<double>(stats.first) / stats.second;
+		cumulative += 1.0 - rate + 0.05;
+		arrangement_cdf[a] = cumulative;
 	}
+	stats_since_cdf = 0;
 }
 
 // =============================
@@ -178,21 +252,23 @@ void ISMCTS::randomizeUnrevealedPieces(GST& state, int current_iteration) {
  * * was available in determinizations, rather than just visits.
  */
 double ISMCTS::calculateUCB(const Node* node) const {
+	if (!node) return std::numeric_limits<double>::infinity();
+
+	// Virtual loss: in-flight descents count as extra visits that were all lost (-1 each)
+	const int pending = node->virtual_loss.load(std::memory_order_relaxed);
+	const int n = node->visits.load(std::memory_order_relaxed) + pending;
+
 	// Infinite priority for unvisited nodes
-	if (!node || node->visits == 0) return std::numeric_limits<double>::infinity();
+	if (n == 0) return std::numeric_limits<double>::infinity();
 
 	// Exploitation: Average reward (-1 to 1)
-	double mean = static_cast<double>(node->wins) / node->visits;
+	double mean = (node->wins.load(std::memory_order_relaxed) - pending) / n;
 
 	// Exploration: Based on availability count from parent
 	int avail = 1;	// Avoid log(0)
-	if (node->parent) {
-		const auto& m = node->parent->avail_cnt;
-		auto it = m.find(node->move);
-		if (it != m.end()) avail = it->second;
-	}
+	if (node->parent) avail = std::max(1, node->parent->avail_cnt[Node::slot(node->move)]);
 
-	int visits = std::max(1, node->visits);
+	int visits = std::max(1, n);
 
 	// UCB Formula
 	double exploration =
@@ -209,6 +285,7 @@ double ISMCTS::calculateUCB(const Node* node) const {
  * @brief Phase 1: Selection
  * * Traverses the tree. Because edges vary by determinization, we check
  * * if the current node is "fully expanded" relative to the current determinized state.
+ * * Each step holds the node's lock while it reads children and updates avail_cnt.
  */
 void ISMCTS::selection(Node*& node, GST& d) {
 	while (!d.is_over()) {
@@ -216,46 +293,33 @@ void ISMCTS::selection(Node*& node, GST& d) {
 		int n = d.gen_all_move(moves);
 		if (n == 0) break;
 
+		std::lock_guard<Node> guard(*node);
+
 		// Update availability count for these compatible moves
 		for (int i = 0; i < n; ++i) {
-			node->avail_cnt[moves[i]]++;
+			node->avail_cnt[Node::slot(moves[i])]++;
 		}
 
 		// Check if node is fully expanded w.r.t the current determinization (d)
 		// i.e., Do all valid moves in 'd' already have corresponding children?
-		bool fully = true;
-		for (int i = 0; i < n; ++i) {
-			bool found = false;
-			for (auto& ch : node->children)
-				if (ch->move == moves[i]) {
-					found = true;
-					break;
-				}
-			if (!found) {
-				fully = false;
-				break;
-			}
-		}
+		const uint64_t legal = Node::moveMask(moves, n);
 
 		// If not fully expanded, stop selection here and proceed to expansion phase
-		if (!fully) return;
-
-		// Filter children: only consider children compatible with current 'd'
-		std::vector<Node*> cand;
-		cand.reserve(node->children.size());
-		for (auto& ch : node->children)
-			if (std::find(moves, moves + n, ch->move) != moves + n) cand.push_back(ch.get());
-
-		if (cand.empty()) return;  // Defense check
+		if (legal & ~node->expanded) return;
 
+		// Compatible children are exactly the 'legal' slots
 		// Heuristic: Prioritize unvisited compatible children first
-		std::vector<Node*> unvisited;
-		for (auto* c : cand)
-			if (c->visits == 0) unvisited.push_back(c);
+		// (a child another worker is already exploring does not count as unvisited)
+		uint64_t unvisited = 0;
+		for (uint64_t m = legal; m; m &= m - 1) {
+			const Node* c = node->slotChild(__builtin_ctzll(m));
+			if (c->visits == 0 && c->virtual_loss == 0) unvisited |= m & -m;
+		}
 
-		if (!unvisited.empty()) {
-			std::uniform_int_distribution<int> pick(0, (int)unvisited.size() - 1);
-			Node* next = unvisited[pick(rng)];
+		if (unvisited) {
+			std::uniform_int_distribution<int> pick(0, __builtin_popcountll(unvisited) - 1);
+			Node* next = node->slotChild(Node::nthBit(unvisited, pick(rng)));
+			if (vloss) next->virtual_loss += vloss;
 			node = next;
 			d.do_move(node->move);
 			continue;
@@ -265,13 +329,15 @@ void ISMCTS::selection(Node*& node, GST& d) {
 		Node* best = nullptr;
 		double bestU = -1e100;
 
-		for (auto* c : cand) {
+		for (uint64_t m = legal; m; m &= m - 1) {
+			Node* c = node->slotChild(__builtin_ctzll(m));
 			const double u = calculateUCB(c);
 			if (u > bestU) {
 				bestU = u;
 				best = c;
 			}
 		}
+		if (vloss) best->virtual_loss += vloss;
 		node = best;
 		d.do_move(node->move);
 	}
@@ -287,39 +353,29 @@ Node* ISMCTS::expansion(Node* node, GST& determinizedState) {
 	int moves[MAX_MOVES];
 	int moveCount = determinizedState.gen_all_move(moves);
 
-	// U = Set of legal moves in 'd' that do NOT have children yet
-	std::vector<int> U;
-	U.reserve(moveCount);
-	for (int i = 0; i < moveCount; ++i) {
-		bool used = false;
-		for (auto& ch : node->children)
-			if (ch->move == moves[i]) {
-				used = true;
-				break;
-			}
-		if (!used) U.push_back(moves[i]);
-	}
+	// Another worker may expand this node concurrently; U must be computed under the lock
+	std::lock_guard<Node> guard(*node);
 
-	if (U.empty()) return nullptr;
+	// U = Set of legal moves in 'd' that do NOT have children yet
+	const uint64_t U = Node::moveMask(moves, moveCount) & ~node->expanded;
+	if (!U) return nullptr;
 
 	// Pick one unexpanded move randomly
-	int move = U[std::uniform_int_distribution<int>(0, (int)U.size() - 1)(rng)];
+	int pick = std::uniform_int_distribution<int>(0, __builtin_popcountll(U) - 1)(rng);
+	int move = Node::slotMove(Node::nthBit(U, pick));
 
-	auto newNode = std::make_unique<Node>(move);
-	newNode->parent = node;
-	Node* ret = newNode.get();
-	node->children.push_back(std::move(newNode));
-	return ret;
+	Node* newNode = tree_pool->create(chunk, move, node);
+	newNode->virtual_loss = vloss;
+	return newNode;
 }
 
 /**
  * @brief Phase 3: Simulation (Rollout)
- * * Epsilon-greedy simulation using weighted heuristics (DATA& d).
+ * * Epsilon-greedy simulation using weighted heuristics (EvalWeights& d).
  * @return 1.0 if root_player wins, -1.0 otherwise.
  */
-double ISMCTS::simulation(GST& state, DATA& d, int root_player) {
-	GST simState = state;
-
+double ISMCTS::simulation(GST& simState, const EvalWeights& d, int root_player,
+						  std::mt19937& gen, pcg32* policy) {
 	int moves[MAX_MOVES];
 	int moveCount;
 	int maxMoves = 200;
@@ -339,14 +395,14 @@ double ISMCTS::simulation(GST& state, DATA& d, int root_player) {
 
 		if (simState.nowTurn == USER) {
 			// User Policy: Epsilon-Greedy
-			if (probDist(rng) < epsilon) {
-				move = moves[pick(rng)];
+			if (probDist(gen) < epsilon) {
+				move = moves[pick(gen)];
 			} else {
-				move = simState.highest_weight(d);	// Greedy choice based on weights
+				move = simState.highest_weight(d, policy);	 // Greedy choice based on weights
 			}
 		} else {
 			// Enemy Policy: Random
-			move = moves[pick(rng)];
+			move = moves[pick(gen)];
 		}
 
 		simState.do_move(move);
@@ -361,6 +417,33 @@ double ISMCTS::simulation(GST& state, DATA& d, int root_player) {
 	return 0.0;
 }
 
+/**
+ * @brief Leaf-parallel rollouts: K playouts from the same leaf, averaged.
+ * * Rollout i always uses leaf_rngs[i] and leaf_policies[i] and plays on its own copy
+ * * leaf_states[i] of the leaf, so neither streams nor boards are shared between threads,
+ * * and the result does not depend on which pool thread ran the slot.
+ */
+double ISMCTS::batchedSimulation(GST& state, const EvalWeights& d, int root_player) {
+	struct Batch {
+		GST& state;
+		const EvalWeights& d;
+		int root_player;
+		double results[MAX_LEAF_ROLLOUTS];
+	} batch{state, d, root_player, {}};
+	double* results = batch.results;
+
+	// Capture just two pointers so the std::function stores the lambda without allocating
+	leaf_pool->parallel_for(leaf_rollouts, [this, &batch](int i) {
+		leaf_states[i] = batch.state;
+		batch.results[i] = simulation(leaf_states[i], batch.d, batch.root_player, leaf_rngs[i],
+									  &leaf_policies[i]);
+	});
+
+	double sum = 0.0;
+	for (int i = 0; i < leaf_rollouts; i++) sum += results[i];
+	return sum / leaf_rollouts;
+}
+
 /**
  * @brief Phase 4: Backpropagation
  * * Updates stats. Note: This assumes fixed root perspective (wins are accumulated).
@@ -369,8 +452,8 @@ void ISMCTS::backpropagation(Node* leaf, double result) {
 	// Standard backprop (Non-Minimax update)
 	// Wins are always from the perspective of the root player
 	for (Node* p = leaf; p; p = p->parent) {
-		p->visits += 1;
-		p->wins += result;
+		p->update(result);
+		if (vloss && p->parent) p->virtual_loss -= vloss;  // Root never receives virtual loss
 	}
 }
 
@@ -379,23 +462,31 @@ void ISMCTS::backpropagation(Node* leaf, double result) {
 // =============================
 
 /**
- * @brief Main ISMCTS Loop
+ * @brief Sequential ISMCTS loop over this object's own tree.
  */
-int ISMCTS::findBestMove(GST& game, DATA& d) {
-	// 1. Reset Tree
-	Node::cleanup(root);
-	root.reset(new Node());
-	arrangement_stats.clear();
-
-	// Identify Root Player to anchor simulation results
-	int root_player = game.nowTurn;
-
-	// 2. Main Simulation Loop
+void ISMCTS::runIterations(const GST& game, const EvalWeights& d, int root_player,
+						   Node* searchRoot) {
+	prepareArrangements(game);
+
+	// One scratch board per call (= per thread); every iteration rewinds it to these plies.
+	// Only the hidden colors differ between determinizations, and undo restores the rest.
+	GST determinizedState = game;
+	const int root_plies = determinizedState.n_plies;
+	bool late_by_time = false;	// Past the middle of a timed search
 	for (int i = 0; i < simulations; i++) {
-		Node* currentNode = root.get();
+		if (stop_search.load(std::memory_order_relaxed)) break;
 
-		// Step A: Determinization (Sample a specific world)
-		GST determinizedState = getDeterminizedState(game, i);
+		// Reading the clock every iteration is measurable; poll it in strides instead
+		if (timed && i % TIME_CHECK_INTERVAL == 0) {
+			auto now = std::chrono::steady_clock::now();
+			if (now >= deadline) break;
+			late_by_time = now >= stats_from;
+		}
+		Node* currentNode = searchRoot;
+
+		// Step A: Determinization (Sample a specific world by re-coloring the hidden pieces)
+		// Inference stats are used in the latter half of the iterations or of the time
+		randomizeUnrevealedPieces(determinizedState, late_by_time || i >= simulations / 2);
 
 		// Step B: Selection
 		selection(currentNode, determinizedState);
@@ -409,25 +500,260 @@ int ISMCTS::findBestMove(GST& game, DATA& d) {
 			}
 		}
 
-		// Step D: Simulation
-		double result = simulation(determinizedState, d, root_player);
+		// Step D: Simulation (optionally a leaf-parallel batch)
+		double result = leaf_rollouts > 1 ? batchedSimulation(determinizedState, d, root_player)
+										  : simulation(determinizedState, d, root_player, rng);
 
 		// Step E: Update Inference Stats (Arrangement Win Rates)
-		std::string arrangementKey;
-		const bool* revealed = game.get_revealed();
-		for (int i = PIECES; i < PIECES * 2; i++) {
-			if (!revealed[i]) {
-				int color = determinizedState.get_color(i);
-				arrangementKey += (color == -RED ? 'R' : 'B');
-			}
+		if (hidden_count > 0) {
+			auto& stats = arrangement_stats[arrangementRank(determinizedState)];
+			if (result > 0) stats.first += 1;  // Wins
+			stats.second += 1;				   // Total simulations for this arrangement
+			stats_since_cdf += stats_since_cdf >= 0;
 		}
-		auto& stats = arrangement_stats[arrangementKey];
-		if (result > 0) stats.first += 1;  // Wins
-		stats.second += 1;				   // Total simulations for this arrangement
+
+		// Rewind the scratch board to the root for the next determinization
+		determinizedState.undo_to(root_plies);
 
 		// Step F: Backpropagation
 		backpropagation(currentNode, result);
 	}
+}
+
+/**
+ * @brief Hands worker 't' its share of the iterations and fresh seeds from this object's RNG.
+ * * Seeds (search and rollout policy) are drawn from this object's RNG, so one seed
+ * * reproduces a search.
+ */
+void ISMCTS::prepareWorker(int t) {
+	ISMCTS& worker = *workers[t];
+	// Split the iteration budget; the first (simulations % num_threads) workers get one extra
+	worker.simulations = simulations / num_threads + (t < simulations % num_threads ? 1 : 0);
+	worker.rng.seed(rng());
+	worker_seeds[t] = rng();
+	worker.timed = timed;
+	worker.deadline = deadline;
+	worker.stats_from = stats_from;
+}
+
+/**
+ * @brief Runs worker t's iterations as task t of worker_pool.
+ */
+void ISMCTS::runWorkers(const GST& game, const EvalWeights& d, int root_player, Node* shared) {
+	struct Job {
+		ISMCTS* self;
+		const GST& game;
+		const EvalWeights& d;
+		int root_player;
+		Node* shared;
+	} job{this, game, d, root_player, shared};
+
+	// Capture one pointer so the std::function stores the lambda without allocating
+	worker_pool->parallel_for(num_threads, [&job](int t) {
+		ISMCTS& worker = *job.self->workers[t];
+		GST::seed_policy(job.self->worker_seeds[t]);  // The thread that runs worker t
+		// runIterations plays on its own scratch copy, so 'game' is only read
+		worker.runIterations(job.game, job.d, job.root_player,
+							 job.shared ? job.shared : worker.root);
+	});
+}
+
+/**
+ * @brief Root-parallel search: independent workers, merged root statistics.
+ * * Workers are plain ISMCTS objects, so each one has its own tree, arrangement_stats
+ * * and RNG. Their arenas are rewound, not rebuilt, for every search.
+ */
+void ISMCTS::runRootParallel(GST& game, const EvalWeights& d, int root_player) {
+	for (int t = 0; t < num_threads; t++) {
+		ISMCTS& worker = *workers[t];
+		prepareWorker(t);
+		worker.vloss = 0;
+		worker.tree_pool = worker.pool.get();
+		worker.pool->reset();
+		worker.root = worker.pool->create();
+	}
+	runWorkers(game, d, root_player, nullptr);
+
+	// Merge root children by move (robust-child selection only needs visits/wins)
+	for (auto& worker : workers) {
+		Node* wroot = worker->root;
+		root->visits += wroot->visits;
+		root->wins = root->wins + wroot->wins;
+		for (int k = 0; k < Node::MOVE_SLOTS; k++) root->avail_cnt[k] += wroot->avail_cnt[k];
+
+		for (Node* wchild : wroot->children) {
+			Node* merged = root->child(wchild->move);
+			if (!merged) merged = pool->create(wchild->move, root);
+			merged->visits += wchild->visits;
+			merged->wins = merged->wins + wchild->wins;
+		}
+	}
+}
+
+/**
+ * @brief Tree-parallel search: every worker descends this object's shared root.
+ * * Workers are ISMCTS objects used only for their RNG and arrangement_stats; the
+ * * inference statistics therefore stay per-thread while the tree is shared.
+ */
+void ISMCTS::runTreeParallel(GST& game, const EvalWeights& d, int root_player) {
+	for (int t = 0; t < num_threads; t++) {
+		ISMCTS& worker = *workers[t];
+		prepareWorker(t);
+		worker.vloss = VIRTUAL_LOSS;
+		worker.tree_pool = pool.get();	// Expansions land in the shared tree's arena
+	}
+	runWorkers(game, d, root_player, root);
+}
+
+/**
+ * @brief Fixed-iteration search.
+ */
+int ISMCTS::findBestMove(GST& game, const EvalWeights& d) {
+	stopPondering();
+	timed = false;
+	return search(game, d);
+}
+
+/**
+ * @brief Anytime search bounded by a wall-clock deadline.
+ */
+int ISMCTS::findBestMove(GST& game, const EvalWeights& d,
+						 std::chrono::steady_clock::time_point deadline) {
+	stopPondering();
+
+	// Nothing to think about with a single legal move (common in endgames)
+	int moves[MAX_MOVES];
+	if (game.gen_all_move(moves) == 1) {
+		last_move = -1;	 // The tree was not searched from this state
+		fprintf(stderr, "ISMCTS: single legal move, skipping search\n");
+		return moves[0];
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	timed = true;
+	this->deadline = deadline;
+	stats_from = now + (deadline - now) / 2;
+	int move = search(game, d);
+	timed = false;
+	return move;
+}
+
+/**
+ * @brief Budget = remaining clock / moves we still expect to play, minus a latency reserve.
+ */
+int ISMCTS::moveBudgetMs(int remaining_ms, int plies_played) {
+	int moves_left = std::max(MIN_MOVES_LEFT, (GAME_PLY_LIMIT - plies_played + 1) / 2);
+	int budget = remaining_ms / moves_left - TIME_RESERVE_MS;
+	return std::max(MIN_MOVE_TIME_MS, std::min(budget, remaining_ms / 2));
+}
+
+// =============================
+// Tree Reuse
+// =============================
+
+/**
+ * @brief Searches the subtree under our last move on a background thread.
+ */
+bool ISMCTS::startPondering(const GST& game, const EvalWeights& d) {
+	stopPondering();
+	if (!reuse_tree || !root || last_move < 0) return false;
+
+	Node* ours = root->child(last_move);
+	if (!ours) return false;
+
+	// Rewards stay relative to the side that moves at the root, as in the search itself
+	ponder_state = game;
+	pondered = true;
+	int root_player = root_state.nowTurn;
+	ponder_thread = std::thread([this, &d, ours, root_player]() {
+		int before = ours->visits;
+		runIterations(ponder_state, d, root_player, ours);
+		fprintf(stderr, "ISMCTS: pondered %d iterations\n", ours->visits - before);
+	});
+	return true;
+}
+
+/**
+ * @brief Raises the stop flag and joins the pondering thread.
+ */
+void ISMCTS::stopPondering() {
+	if (!ponder_thread.joinable()) return;
+	stop_search = true;
+	ponder_thread.join();
+	stop_search = false;
+}
+
+/**
+ * @brief Promotes the grandchild (our last move, then the opponent's reply) to root.
+ */
+bool ISMCTS::advanceRoot(const GST& game) {
+	if (!root || last_move < 0) return false;
+
+	// Our piece must have made the move we returned (or been captured by the reply)
+	int our_piece = last_move >> 4;
+	int our_to = root_state.pos[our_piece] + dir_val[last_move & 0xf];
+	if (game.pos[our_piece] != our_to && game.pos[our_piece] != -1) return false;
+
+	// Exactly one enemy piece must have moved by one step
+	int reply = -1;
+	for (int p = PIECES; p < PIECES * 2; p++) {
+		int from = root_state.pos[p], to = game.pos[p];
+		if (from == -1 || to == -1 || from == to) continue;
+		int dir = 0;
+		while (dir < 4 && from + dir_val[dir] != to) dir++;
+		if (dir == 4 || reply != -1) return false;
+		reply = p << 4 | dir;
+	}
+	if (reply == -1) return false;
+
+	Node* ours = root->child(last_move);
+	Node* grandchild = ours ? ours->child(reply) : nullptr;
+	if (!grandchild) return false;
+
+	// Double buffering: copy the survivor out, then drop the whole old tree in O(1)
+	if (!spare_pool) spare_pool.reset(new NodePool());
+	spare_pool->reset();
+	root = spare_pool->copySubtree(grandchild);
+	std::swap(pool, spare_pool);
+	spare_pool->reset();
+	tree_pool = pool.get();
+	return true;
+}
+
+/**
+ * @brief Main ISMCTS Loop
+ */
+int ISMCTS::search(GST& game, const EvalWeights& d) {
+	// 1. Reuse the subtree under the moves actually played, or start a fresh tree
+	bool top_up = false;
+	if (reuse_tree && advanceRoot(game)) {
+		fprintf(stderr, "ISMCTS: reusing subtree with %d visits\n", root->visits.load());
+		top_up = pondered;
+	} else {
+		pool->reset();
+		root = pool->create();
+	}
+	last_move = -1;
+	pondered = false;
+	// Batched rollouts restart from the search RNG, so one seed reproduces a search
+	if (leaf_rollouts > 1) seedLeafRollouts();
+
+	// Identify Root Player to anchor simulation results
+	int root_player = game.nowTurn;
+
+	// 2. Main Simulation Loop (single-threaded unless parallelism is requested)
+	// A pondered root only needs topping up to 'simulations' visits, but every search
+	// samples at least MIN_FRESH_DIVISOR-th of them from the new state. Without pondering
+	// the reused visits come on top of a full search, as before tree reuse.
+	const int full = simulations;
+	if (top_up) simulations = std::max(full / MIN_FRESH_DIVISOR, full - root->visits.load());
+	if (num_threads > 1 && parallel_mode == ParallelMode::Tree)
+		runTreeParallel(game, d, root_player);
+	else if (num_threads > 1)
+		runRootParallel(game, d, root_player);
+	else
+		runIterations(game, d, root_player, root);
+	simulations = full;
 
 	// 3. Select Best Move
 	Node* bestChild = nullptr;
@@ -436,10 +762,10 @@ int ISMCTS::findBestMove(GST& game, DATA& d) {
 	bool hasValidMoves = false;
 
 	// Robust Child Criteria: Pick the most visited node
-	for (auto& child : root->children) {
+	for (Node* child : root->children) {
 		if (child->visits > maxVisits) {
 			maxVisits = child->visits;
-			bestChild = child.get();
+			bestChild = child;
 			hasValidMoves = true;
 		}
 	}
@@ -456,12 +782,15 @@ int ISMCTS::findBestMove(GST& game, DATA& d) {
 
 		fprintf(stderr, "ISMCTS Selected: Piece %d, Dir %s\n", piece, dirNames[direction]);
 		fprintf(stderr, "Win Rate: %.2f%%\n",
-				bestChild->visits > 0
-					? static_cast<double>(bestChild->wins) / bestChild->visits * 100
-					: 0.0);
+				bestChild->visits > 0 ? bestChild->wins / bestChild->visits * 100 : 0.0);
 	}
 
 	fprintf(stderr, "Returning Move: %d\n", bestChild->move);
 
+	if (reuse_tree) {
+		root_state = game;
+		last_move = bestChild->move;
+	}
+
 	return bestChild->move;
 }
\ No newline at end of file
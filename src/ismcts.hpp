@@ -9,7 +9,17 @@
 #define ISMCTS_HPP
 
 #include "4T_GST.hpp"
+#include "4T_WEIGHTS.hpp"
 #include "node.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief How ISMCTS spreads a search over several threads.
+ */
+enum class ParallelMode {
+	Root,  ///< One independent tree per thread, root children merged at the end
+	Tree   ///< All threads descend one shared tree (virtual loss + per-node locks)
+};
 
 /**
  * @class ISMCTS
@@ -19,19 +29,89 @@
  * before running MCTS iterations.
  */
 class ISMCTS {
+	// Offline tools (bench) time the search phases one by one
+	friend int main();
+
    private:
 	/// @name Configuration & State
 	/// @{
 	int simulations;			 ///< Number of simulations to perform per search
+	int num_threads;			 ///< Worker threads for parallel search (1 = sequential)
+	ParallelMode parallel_mode;	 ///< Root or tree parallelization when num_threads > 1
+	int vloss;					 ///< Virtual loss applied per descent (0 unless tree-parallel)
 	std::mt19937 rng;			 ///< Random number generator (Mersenne Twister)
-	std::unique_ptr<Node> root;	 ///< Root node of the search tree
+	Node* root;					 ///< Root node of the search tree (lives in *tree_pool)
+	/// @}
+
+	/// @name Node Memory
+	/// @{
+	std::unique_ptr<NodePool> pool;		   ///< Arena holding this object's tree
+	std::unique_ptr<NodePool> spare_pool;  ///< Second arena a reused subtree is copied into
+	NodePool* tree_pool;				   ///< Arena expansions allocate from (shared when tree-parallel)
+	NodePool::Chunk chunk;				   ///< This thread's region of *tree_pool (no pool lock)
+	/// @}
+
+	/// @name Tree Reuse
+	/// @{
+	bool reuse_tree;  ///< Keep the subtree under the actual moves between searches
+	GST root_state;	  ///< Information set the current root was searched from
+	int last_move;	  ///< Move returned for root_state (-1 = tree not reusable)
+	/// @}
+
+	/// @name Pondering
+	/// @{
+	std::thread ponder_thread;		 ///< Background search during the opponent's turn
+	std::atomic<bool> stop_search;	 ///< Asks runIterations to return after the current iteration
+	GST ponder_state;				 ///< State after our last move (opponent to play)
+	bool pondered;					 ///< The tree under last_move was grown by pondering
+	/// @}
+
+	/// @name Time Budget
+	/// @{
+	bool timed;										  ///< True while a deadline-bounded search runs
+	std::chrono::steady_clock::time_point deadline;	  ///< Wall-clock stop time (if timed)
+	std::chrono::steady_clock::time_point stats_from;  ///< Switch to inference determinization
+	/// @}
+
+	/// @name Parallel Workers
+	/// @{
+	std::vector<std::unique_ptr<ISMCTS>> workers;  ///< Root/tree-parallel workers (setThreads)
+	std::vector<uint32_t> worker_seeds;			   ///< Policy RNG seed of each worker's search
+	std::unique_ptr<ThreadPool> worker_pool;	   ///< Threads that run the workers (caller included)
+	/// @}
+
+	/// @name Leaf Parallelization
+	/// @{
+	int leaf_rollouts;						///< Rollouts per expanded leaf (1 = no batching)
+	std::unique_ptr<ThreadPool> leaf_pool;	///< Threads that run a leaf's rollouts
+	std::vector<std::mt19937> leaf_rngs;	///< One RNG stream per rollout slot
+	std::vector<pcg32> leaf_policies;		///< highest_weight's RNG per rollout slot
+	std::vector<GST> leaf_states;			///< Scratch board per rollout slot
+	/// @}
 
 	/**
-	 * @brief Statistics for unknown piece arrangements.
-	 * * Maps a string representation of a piece arrangement to a pair of <wins, count>.
-	 * * Used to bias determinization based on historical performance (Inference Strategy).
+	 * @brief Largest number of hidden-color arrangements: C(8, 4).
 	 */
-	std::unordered_map<std::string, std::pair<int, int>> arrangement_stats;
+	static constexpr int MAX_ARRANGEMENTS = 70;
+
+	/// @name Arrangement Inference
+	/// @{
+	int hidden_pieces[PIECES];	///< Unrevealed enemy pieces of the searched information set
+	int hidden_count;			///< Number of entries in hidden_pieces
+	int hidden_red;				///< Red pieces among them
+	int arrangement_count;		///< C(hidden_count, hidden_red) valid arrangements
+
+	/// Red-piece bitmask (bit i = hidden_pieces[i] is red) of each arrangement, by rank
+	uint8_t arrangement_masks[MAX_ARRANGEMENTS];
+
+	/**
+	 * @brief Statistics for unknown piece arrangements, as <wins, count>.
+	 * * Indexed by arrangementRank(). Used to bias determinization (Inference Strategy).
+	 */
+	std::pair<int, int> arrangement_stats[MAX_ARRANGEMENTS];
+
+	double arrangement_cdf[MAX_ARRANGEMENTS];  ///< Cumulative sampling weights, by rank
+	int stats_since_cdf;  ///< Stats updates since arrangement_cdf was rebuilt (-1 = stale)
 	/// @}
 
 	/// @name MCTS Core Stages
@@ -58,12 +138,26 @@ class ISMCTS {
 	/**
 	 * @brief Phase 3: Simulation (Rollout)
 	 * * Simulates a game to completion using a random or heuristic policy.
-	 * @param state The starting state for simulation.
+	 * @param simState The starting state; the rollout is played on it, the caller rewinds it.
 	 * @param d Shared data context.
 	 * @param root_player The ID of the player at the root (to calculate relative reward).
+	 * @param gen Random generator for this rollout (lets parallel rollouts use own streams).
+	 * @param policy highest_weight's RNG (nullptr = the calling thread's policy RNG).
 	 * @return double The simulation result (reward).
 	 */
-	double simulation(GST& state, DATA& d, int root_player);
+	double simulation(GST& state, const EvalWeights& d, int root_player, std::mt19937& gen,
+					  pcg32* policy = nullptr);
+
+	/**
+	 * @brief Leaf-parallel simulation: runs 'leaf_rollouts' rollouts from one leaf.
+	 * @return double The mean reward of the batch.
+	 */
+	double batchedSimulation(GST& state, const EvalWeights& d, int root_player);
+
+	/**
+	 * @brief Reseeds leaf_rngs and leaf_policies from rng (at configuration and every search).
+	 */
+	void seedLeafRollouts();
 
 	/**
 	 * @brief Phase 4: Backpropagation
@@ -84,19 +178,113 @@ class ISMCTS {
 	double calculateUCB(const Node* node) const;
 
 	/**
-	 * @brief Creates a concrete game state from the current information set.
-	 * * Samples a specific world by assigning colors/types to hidden pieces.
-	 * @param originalState The current game state with hidden info.
-	 * @param current_iteration Current simulation index (used for adaptive strategies).
-	 * @return GST A fully determined game state.
+	 * @brief Randomizes unrevealed pieces on the board.
+	 * * Pure random shuffle, or weighted by arrangement win rates when 'use_stats' is set.
 	 */
-	GST getDeterminizedState(const GST& originalState, int current_iteration);
+	void randomizeUnrevealedPieces(GST& state, bool use_stats);
 
 	/**
-	 * @brief Randomizes unrevealed pieces on the board.
-	 * * Strategy may shift from pure random to statistically weighted based on 'current_iteration'.
+	 * @brief Enumerates the arrangements of the pieces hidden in 'info' and zeroes their stats.
+	 * * Called once per search (per worker) before any determinization of 'info'.
+	 */
+	void prepareArrangements(const GST& info);
+
+	/**
+	 * @brief Combinatorial-number-system rank of the arrangement 'state' assigns to hidden_pieces.
+	 * @return int Index in [0, arrangement_count).
+	 */
+	int arrangementRank(const GST& state) const;
+
+	/**
+	 * @brief Rebuilds arrangement_cdf from the current arrangement_stats.
 	 */
-	void randomizeUnrevealedPieces(GST& state, int current_iteration);
+	void rebuildArrangementCdf();
+	/// @}
+
+	/// @name Search Drivers
+	/// @{
+	/**
+	 * @brief Runs 'simulations' ISMCTS iterations into the given tree.
+	 * * A timed search also stops at 'deadline', and any search stops once 'stop_search'
+	 * * is raised, whichever comes first.
+	 * * Uses this object's RNG and arrangement_stats; the tree may be shared with
+	 * * other workers (tree parallelization), in which case 'vloss' must be set.
+	 * * Iterations share one scratch copy of 'game': each re-colors the hidden pieces,
+	 * * plays with do_move and rewinds with undo, so nothing is copied per iteration.
+	 * @param game The current game state (containing hidden info, not modified).
+	 * @param d Shared data object (read-only during search).
+	 * @param root_player The player whose perspective rewards are measured from.
+	 * @param searchRoot Root of the tree to grow.
+	 */
+	void runIterations(const GST& game, const EvalWeights& d, int root_player, Node* searchRoot);
+
+	/**
+	 * @brief Points worker 't' at this search: iteration share, RNG seeds and time limits.
+	 */
+	void prepareWorker(int t);
+
+	/**
+	 * @brief Runs every worker's iterations on worker_pool and waits for all of them.
+	 * @param shared The tree-parallel root, or nullptr to grow each worker's own root.
+	 */
+	void runWorkers(const GST& game, const EvalWeights& d, int root_player, Node* shared);
+
+	/**
+	 * @brief Root parallelization: one independent tree per worker thread.
+	 * * Each worker owns its tree, arrangement_stats and RNG stream. After all workers
+	 * * finish, the root children's visits/wins are summed into this object's root.
+	 */
+	void runRootParallel(GST& game, const EvalWeights& d, int root_player);
+
+	/**
+	 * @brief Tree parallelization: all workers grow this object's root concurrently.
+	 * * Workers keep private RNGs and arrangement_stats; visits/wins are atomics, children
+	 * * and avail_cnt are guarded by per-node locks, and virtual loss spreads the threads.
+	 */
+	void runTreeParallel(GST& game, const EvalWeights& d, int root_player);
+
+	/**
+	 * @brief Re-roots the tree at the node reached by our last move and the opponent's reply.
+	 * * The reply is found by diffing enemy piece positions between root_state and 'game'.
+	 * * The promoted grandchild is copied into the spare arena, and the old arena (with
+	 * * all of its siblings) is released at once.
+	 * @return true if a matching grandchild existed and became the new root.
+	 */
+	bool advanceRoot(const GST& game);
+
+	/**
+	 * @brief Shared body of both findBestMove overloads (timing already configured).
+	 */
+	int search(GST& game, const EvalWeights& d);
+	/// @}
+
+	/**
+	 * @brief Virtual visits (each counted as a loss) added to a node while a tree-parallel
+	 * * worker is inside its subtree.
+	 */
+	static constexpr int VIRTUAL_LOSS = 1;
+
+	/**
+	 * @brief Upper bound on rollouts per leaf in leaf-parallel mode.
+	 */
+	static constexpr int MAX_LEAF_ROLLOUTS = 64;
+
+	/**
+	 * @brief Iterations between two clock reads in a timed search.
+	 */
+	static constexpr int TIME_CHECK_INTERVAL = 64;
+
+	/**
+	 * @brief A search on a pondered root runs at least simulations / MIN_FRESH_DIVISOR iterations.
+	 */
+	static constexpr int MIN_FRESH_DIVISOR = 4;
+
+	/// @name Move Time Allocation
+	/// @{
+	static constexpr int GAME_PLY_LIMIT = 200;	  ///< Plies before the game is drawn
+	static constexpr int MIN_MOVES_LEFT = 10;	  ///< Never plan for fewer remaining moves
+	static constexpr int TIME_RESERVE_MS = 50;	  ///< Held back per move for I/O latency
+	static constexpr int MIN_MOVE_TIME_MS = 10;	  ///< Floor for a single move's budget
 	/// @}
 
 	/**
@@ -108,9 +296,62 @@ class ISMCTS {
    public:
 	/**
 	 * @brief Construct a new ISMCTS object.
-	 * @param simulations Number of iterations to run per search.
+	 * @param simulations Number of iterations to run per search (total over all threads).
+	 * @param num_threads Number of root-parallel worker threads (default 1 = sequential).
+	 */
+	ISMCTS(int simulations, int num_threads = 1);
+
+	/**
+	 * @brief Stops pondering (if any) before the tree is released.
+	 */
+	~ISMCTS();
+
+	/**
+	 * @brief Changes the number of root-parallel worker threads used by later searches.
+	 * * The workers and their threads are created here and kept across searches.
+	 * @param num_threads Thread count; values below 1 are clamped to 1.
+	 */
+	void setThreads(int num_threads);
+
+	/**
+	 * @brief Chooses root or tree parallelization for multi-threaded searches.
+	 */
+	void setParallelMode(ParallelMode mode);
+
+	/**
+	 * @brief Enables leaf parallelization for single-threaded searches.
+	 * * Each iteration runs 'rollouts' playouts from the same expanded leaf and
+	 * * determinization on a thread pool and backpropagates their mean once.
+	 * * Root/tree-parallel workers do not batch their leaves.
+	 * @param rollouts Rollouts per leaf (1 disables batching).
+	 * @param threads Pool size including the calling thread (0 = one per rollout).
+	 */
+	void setLeafParallel(int rollouts, int threads = 0);
+
+	/**
+	 * @brief Keeps the search tree between consecutive findBestMove calls.
+	 * * The next search continues from the subtree under our move and the opponent's
+	 * * reply. Root-parallel searches only keep merged root statistics, so they
+	 * * effectively restart every move.
+	 */
+	void setTreeReuse(bool enable);
+
+	/**
+	 * @brief Starts searching in the background while the opponent thinks.
+	 * * Grows the subtree under the move just returned, from 'game' (our move already
+	 * * applied), so that the next findBestMove reuses it. Runs until stopPondering()
+	 * * or 'simulations' iterations. Requires tree reuse; otherwise it does nothing.
+	 * @param game The state after our move (opponent to play).
+	 * @param d Shared data object (must outlive the pondering).
+	 * @return true if a background search was started.
 	 */
-	ISMCTS(int simulations);
+	bool startPondering(const GST& game, const EvalWeights& d);
+
+	/**
+	 * @brief Stops a running background search and waits for it to finish.
+	 * * Safe to call when not pondering.
+	 */
+	void stopPondering();
 
 	/**
 	 * @brief Resets the ISMCTS tree and state.
@@ -123,7 +364,29 @@ class ISMCTS {
 	 * @param d Shared data object.
 	 * @return int The best move index found.
 	 */
-	int findBestMove(GST& game, DATA& d);
+	int findBestMove(GST& game, const EvalWeights& d);
+
+	/**
+	 * @brief Anytime search: iterates until 'deadline' (or the 'simulations' cap).
+	 * * Inference-based determinization starts after half of the available time.
+	 * * A root with a single legal move returns it without searching.
+	 * @param game The current game state (containing hidden info).
+	 * @param d Shared data object.
+	 * @param deadline Wall-clock time by which the move must be chosen.
+	 * @return int The best move index found.
+	 */
+	int findBestMove(GST& game, const EvalWeights& d,
+					 std::chrono::steady_clock::time_point deadline);
+
+	/**
+	 * @brief Splits the remaining game clock into a budget for the next move.
+	 * * Spreads 'remaining_ms' over the moves we still expect to make before the
+	 * * ply limit, keeping a small reserve for communication latency.
+	 * @param remaining_ms Time left on our clock, in milliseconds.
+	 * @param plies_played Plies (both sides) already played in this game.
+	 * @return int Milliseconds to spend on this move.
+	 */
+	static int moveBudgetMs(int remaining_ms, int plies_played);
 
 	/**
 	 * @brief Debug helper: Recursively prints tree statistics.
@@ -17,7 +17,7 @@ constexpr int MCTS::dir_val[4];
 /**
  * @brief Construct a new MCTS object and seed the RNG.
  */
-MCTS::MCTS(int simulations) : simulations(simulations) {
+MCTS::MCTS(int simulations) : simulations(simulations), root(nullptr) {
 	auto seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 	rng.seed(static_cast<unsigned int>(seed));
 }
@@ -29,7 +29,8 @@ void MCTS::reset() {
 	auto seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 	rng.seed(static_cast<unsigned int>(seed));
 
-	Node::cleanup(root);
+	pool.reset();
+	root = nullptr;
 }
 
 // =============================
@@ -64,7 +65,7 @@ double MCTS::calculateUCB(const Node* node) const {
 	double exploitation = static_cast<double>(node->wins) / node->visits;
 	// Exploration parameter controls the balance between width and depth search
 	double exploration =
-		EXPLORATION_PARAM * std::sqrt(std::log(node->parent->visits) / node->visits);
+		EXPLORATION_PARAM * std::sqrt(std::log(node->parent->visits.load()) / node->visits);
 
 	return exploitation + exploration;
 }
@@ -82,18 +83,18 @@ void MCTS::selection(Node*& node, GST& state) {
 		Node* bestChild = nullptr;
 		double bestUCB = -std::numeric_limits<double>::infinity();
 
-		for (auto& child : node->children) {
+		for (Node* child : node->children) {
 			// If a child has never been visited, prioritize it immediately (Infinite UCB)
 			if (child->visits == 0) {
 				state.do_move(child->move);
-				node = child.get();
+				node = child;
 				return;
 			}
 
-			double ucb = calculateUCB(child.get());
+			double ucb = calculateUCB(child);
 			if (ucb > bestUCB) {
 				bestUCB = ucb;
-				bestChild = child.get();
+				bestChild = child;
 			}
 		}
 
@@ -115,6 +116,7 @@ void MCTS::expansion(Node* node, GST& state) {
 
 	int moves[MAX_MOVES];
 	int moveCount = state.gen_all_move(moves);
+	pool.reserveChildren(node, moveCount);	// One contiguous block for all children
 
 	for (int i = 0; i < moveCount; i++) {
 		int move = moves[i];
@@ -129,9 +131,7 @@ void MCTS::expansion(Node* node, GST& state) {
 		GST newState = state;
 		newState.do_move(move);
 
-		std::unique_ptr<Node> newNode(new Node(move));
-		newNode->parent = node;
-		node->children.push_back(std::move(newNode));
+		pool.create(move, node);
 	}
 }
 
@@ -174,8 +174,7 @@ int MCTS::simulation(GST& state) {
  */
 void MCTS::backpropagation(Node* node, int result) {
 	while (node != nullptr) {
-		node->visits += 1;
-		node->wins += result;
+		node->update(result);
 		result = -result;  // Toggle result for Minimax (switch perspective)
 		node = node->parent;
 	}
@@ -190,12 +189,12 @@ void MCTS::backpropagation(Node* node, int result) {
  */
 int MCTS::findBestMove(GST& game) {
 	// 1. Clean up previous tree and initialize root
-	Node::cleanup(root);
-	root.reset(new Node());
+	pool.reset();
+	root = pool.create();
 
 	// 2. Main MCTS Loop
 	for (int i = 0; i < simulations; i++) {
-		Node* currentNode = root.get();
+		Node* currentNode = root;
 
 		GST tempGame = game;
 
@@ -215,8 +214,7 @@ int MCTS::findBestMove(GST& game) {
 		if (!currentNode->children.empty()) {
 			std::uniform_int_distribution<> dist(0, currentNode->children.size() - 1);
 			int randomIndex = dist(rng);
-			auto it = std::next(currentNode->children.begin(), randomIndex);
-			nodeToSimulate = it->get();
+			nodeToSimulate = currentNode->children[randomIndex];
 		}
 
 		// Stage 3: Simulation
@@ -230,10 +228,10 @@ int MCTS::findBestMove(GST& game) {
 	Node* bestChild = nullptr;
 	int maxVisits = -1;
 
-	for (auto& child : root->children) {
+	for (Node* child : root->children) {
 		if (child->visits > maxVisits) {
 			maxVisits = child->visits;
-			bestChild = child.get();
+			bestChild = child;
 		}
 	}
 
@@ -24,7 +24,8 @@ class MCTS {
 	/// @{
 	int simulations;			 ///< Number of simulations to perform per search
 	std::mt19937 rng;			 ///< Random number generator (Mersenne Twister)
-	std::unique_ptr<Node> root;	 ///< Smart pointer to the root node of the search tree
+	NodePool pool;				 ///< Arena holding the search tree (reset per search)
+	Node* root;					 ///< Root node of the search tree (lives in pool)
 	/// @}
 
 	/// @name MCTS Core Stages
@@ -19,7 +19,112 @@
  */
 Node::Node(int move)
 	: move(move),	   // The move from parent to this node
-	  wins(0),		   // Initialize win score to 0
-	  visits(0),	   // Initialize visit count to 0
-	  parent(nullptr)  // Initialize parent pointer to nullptr (assigned later)
-{}
\ No newline at end of file
+	  wins(0),			// Initialize win score to 0
+	  visits(0),		// Initialize visit count to 0
+	  virtual_loss(0),	// No in-flight descents yet
+	  parent(nullptr),	// Initialize parent pointer to nullptr (assigned later)
+	  expanded(0),		// No children yet
+	  busy(false)		// Unlocked
+{
+	std::memset(avail_cnt, 0, sizeof(avail_cnt));
+	std::memset(child_index, -1, sizeof(child_index));
+}
+// =============================
+// NodePool Implementation
+// =============================
+
+constexpr int Node::MOVE_SLOTS;
+constexpr size_t NodePool::SLAB_BYTES;
+
+/**
+ * @brief Destroys the remaining nodes and returns every slab to the heap.
+ */
+NodePool::~NodePool() {
+	reset();
+	for (char* slab : slabs) ::operator delete(slab);
+}
+
+/**
+ * @brief Hands 'chunk' the next slab, allocating one only when every slab is in use.
+ */
+void NodePool::refill(Chunk& chunk) {
+	std::lock_guard<std::mutex> guard(mtx);
+	if (next_slab == slabs.size()) slabs.push_back(static_cast<char*>(::operator new(SLAB_BYTES)));
+	chunk.data = slabs[next_slab++];
+	chunk.offset = 0;
+	chunk.owner = this;
+	chunk.epoch = epoch;
+}
+
+/**
+ * @brief Carves 'bytes' out of the chunk's slab, refilling it when stale or full.
+ */
+void* NodePool::allocate(Chunk& chunk, size_t bytes, size_t align) {
+	size_t offset = (chunk.offset + align - 1) & ~(align - 1);
+	if (chunk.owner != this || chunk.epoch != epoch || offset + bytes > SLAB_BYTES) {
+		refill(chunk);
+		offset = 0;
+	}
+	chunk.offset = offset + bytes;
+	return chunk.data + offset;
+}
+
+/**
+ * @brief Copies the child pointers into a larger block (the old block is abandoned).
+ */
+void NodePool::growChildren(Chunk& chunk, Node* node, int capacity) {
+	ChildList& list = node->children;
+	Node** block = static_cast<Node**>(allocate(chunk, sizeof(Node*) * capacity, alignof(Node*)));
+	if (list.count) std::memcpy(block, list.data, sizeof(Node*) * list.count);
+	list.data = block;
+	list.capacity = capacity;
+}
+
+/**
+ * @brief Placement-constructs a node and links it under its parent.
+ */
+Node* NodePool::create(Chunk& chunk, int move, Node* parent) {
+	Node* node = new (allocate(chunk, sizeof(Node), alignof(Node))) Node(move);
+	node_count.fetch_add(1, std::memory_order_relaxed);
+
+	if (parent) {
+		ChildList& list = parent->children;
+		if (list.count == list.capacity)
+			growChildren(chunk, parent, list.capacity ? list.capacity * 2 : 4);
+		parent->child_index[Node::slot(move)] = static_cast<int8_t>(list.count);
+		parent->expanded |= 1ULL << Node::slot(move);
+		list.data[list.count++] = node;
+		node->parent = parent;
+	}
+	return node;
+}
+
+/**
+ * @brief Ensures one contiguous block holds all of a node's upcoming children.
+ */
+void NodePool::reserveChildren(Node* node, int capacity) {
+	if (capacity > node->children.capacity) growChildren(own, node, capacity);
+}
+
+/**
+ * @brief Rewinds the pool; Node is trivially destructible, so nothing is run per node.
+ */
+void NodePool::reset() {
+	std::lock_guard<std::mutex> guard(mtx);
+	next_slab = 0;
+	epoch++;
+	node_count = 0;
+}
+
+/**
+ * @brief Recursively copies statistics and children (trees are only a few dozen plies deep).
+ */
+Node* NodePool::copySubtree(const Node* src, Node* parent) {
+	Node* copy = create(src->move, parent);
+	copy->wins = src->wins.load();
+	copy->visits = src->visits.load();
+	std::memcpy(copy->avail_cnt, src->avail_cnt, sizeof(copy->avail_cnt));
+	reserveChildren(copy, src->children.size());
+	for (Node* child : src->children) copySubtree(child, copy);
+	return copy;
+}
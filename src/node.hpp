@@ -10,6 +10,28 @@
 
 #include "4T_header.h"
 
+class Node;
+
+/**
+ * @struct ChildList
+ * @brief Contiguous block of child pointers carved out of a NodePool.
+ * * Grows by doubling into a fresh block; the abandoned block is reclaimed when
+ * * the pool is reset. Iterable with range-for.
+ */
+struct ChildList {
+	Node** data = nullptr;	///< First child pointer (arena memory, not owned)
+	int count = 0;			///< Number of children in use
+	int capacity = 0;		///< Slots available before the block must grow
+
+	Node** begin() const { return data; }
+	Node** end() const { return data + count; }
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+	Node* operator[](int i) const { return data[i]; }
+};
+
+class NodePool;
+
 /**
  * @class Node
  * @brief Represents a node in the Monte Carlo Tree Search (MCTS) tree.
@@ -18,45 +40,200 @@
  */
 class Node {
    public:
+	/// Number of distinct moves: 16 pieces x 4 directions
+	static constexpr int MOVE_SLOTS = PIECES * 2 * 4;
+
+	/**
+	 * @brief Dense index of a move (piece<<4 | dir) in [0, MOVE_SLOTS).
+	 */
+	static int slot(int move) { return (move >> 4) * 4 + (move & 0xf); }
+
+	/**
+	 * @brief Inverse of slot(): the move stored in a given slot.
+	 */
+	static int slotMove(int s) { return (s >> 2) << 4 | (s & 3); }
+
+	/**
+	 * @brief Bit set of slot()s for a move list (e.g. the output of gen_all_move).
+	 */
+	static uint64_t moveMask(const int* moves, int n) {
+		uint64_t mask = 0;
+		for (int i = 0; i < n; ++i) mask |= 1ULL << slot(moves[i]);
+		return mask;
+	}
+
+	/**
+	 * @brief Picks the k-th (0-based) set bit of 'mask' and returns its index.
+	 */
+	static int nthBit(uint64_t mask, int k) {
+		while (k-- > 0) mask &= mask - 1;
+		return __builtin_ctzll(mask);
+	}
+
+	/**
+	 * @brief Returns the child reached by 'move', or nullptr if it is not expanded.
+	 */
+	Node* child(int move) const {
+		int idx = child_index[slot(move)];
+		return idx < 0 ? nullptr : children[idx];
+	}
+
+	/**
+	 * @brief Returns the child stored in slot 's' (which must be set in 'expanded').
+	 */
+	Node* slotChild(int s) const { return children[child_index[s]]; }
+
 	/// @name Node Statistics
 	/// @{
-	int move;	  ///< The move taken from parent to reach this node (-1 indicates root)
-	double wins;  ///< Accumulated win score from simulations
-	int visits;	  ///< Total number of times this node has been visited
-	std::unordered_map<int, int> avail_cnt;	 ///< Tracks available moves or state counts
+	int move;					///< The move taken from parent to reach this node (-1 indicates root)
+	std::atomic<double> wins;	///< Accumulated win score from simulations
+	std::atomic<int> visits;	///< Total number of times this node has been visited
+	std::atomic<int> virtual_loss;	///< Pending virtual losses from in-flight tree-parallel descents
+	int avail_cnt[MOVE_SLOTS];	///< Times each move was legal here, by slot() (guarded by lock())
 	/// @}
 
 	/// @name Tree Structure
 	/// @{
-	Node* parent;  ///< Pointer to parent node (does not own memory)
-	std::vector<std::unique_ptr<Node>>
-		children;  ///< List of child nodes (owns memory via unique_ptr)
+	Node* parent;		 ///< Pointer to parent node (does not own memory)
+	ChildList children;	 ///< Child nodes, allocated from the owning NodePool (guarded by lock())
+	int8_t child_index[MOVE_SLOTS];	 ///< Position in 'children' by slot(), -1 if not expanded
+	uint64_t expanded;				 ///< Bit slot() set for every expanded child (guarded by lock())
 	/// @}
 
+   private:
+	std::atomic<bool> busy;	 ///< Spinlock flag for lock()/unlock()
+
+   public:
 	/**
 	 * @brief Construct a new Node object.
 	 * @param move The move leading to this node (default is -1 for root).
 	 */
 	Node(int move = -1);
 
+	/// @name Concurrency (Tree Parallelization)
+	/// @{
 	/**
-	 * @brief Recursively cleans up the entire subtree.
-	 * * @note This function provides a safe way to destroy deep trees, preventing
-	 * potential stack overflow issues that might occur with default destructors.
-	 * * @param node Reference to the unique_ptr of the node to be cleaned.
-	 */
-	static void cleanup(std::unique_ptr<Node>& node) {
-		if (node) {
-			// Recursively clean up child nodes
-			for (auto& child : node->children) {
-				cleanup(child);
-			}
-			// Clear the children vector of the current node
-			node->children.clear();
-			// Reset the current node (releases memory)
-			node.reset();
+	 * @brief Acquires the node's spinlock (BasicLockable, usable with std::lock_guard).
+	 * * Guards 'children' and 'avail_cnt'; statistics are atomics and need no lock.
+	 */
+	void lock() {
+		while (busy.exchange(true, std::memory_order_acquire)) {
+			while (busy.load(std::memory_order_relaxed)) std::this_thread::yield();
 		}
 	}
+
+	/**
+	 * @brief Releases the node's spinlock.
+	 */
+	void unlock() { busy.store(false, std::memory_order_release); }
+
+	/**
+	 * @brief Atomically adds one visit and the given reward.
+	 * @param result Reward to accumulate into 'wins'.
+	 */
+	void update(double result) {
+		visits.fetch_add(1, std::memory_order_relaxed);
+		double cur = wins.load(std::memory_order_relaxed);
+		while (!wins.compare_exchange_weak(cur, cur + result, std::memory_order_relaxed)) {
+		}
+	}
+	/// @}
+};
+static_assert(std::is_trivially_destructible<Node>::value,
+			  "NodePool::reset() drops nodes without running destructors");
+
+/**
+ * @class NodePool
+ * @brief Per-search bump allocator for Node objects and their child blocks.
+ * * Memory is handed out from large slabs that are kept across reset(), so after
+ * * the first search no heap allocation happens for tree growth, and tearing down
+ * * a tree is a cursor rewind instead of a walk over every node.
+ * * Nodes are carved out of a Chunk, a slab owned by one allocating thread. Only
+ * * taking the next slab locks the pool, so tree-parallel workers that each pass
+ * * their own Chunk expand concurrently without a pool-wide lock.
+ */
+class NodePool {
+   public:
+	/**
+	 * @brief One thread's bump region: a whole slab taken from the pool.
+	 * * A chunk left over from another pool or from before reset() is refilled on next use.
+	 */
+	struct Chunk {
+		char* data = nullptr;			  ///< Slab being carved (nullptr = none yet)
+		size_t offset = 0;				  ///< Bytes used in data
+		const NodePool* owner = nullptr;  ///< Pool the slab belongs to
+		unsigned epoch = 0;				  ///< owner's reset() count when the slab was taken
+	};
+
+	NodePool() = default;
+	~NodePool();
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	/**
+	 * @brief Constructs a node in the pool's own chunk and appends it to parent->children.
+	 * * For one thread at a time; concurrent expansions pass their own Chunk instead.
+	 * @param move The move leading to the node (-1 for a root).
+	 * @param parent Parent node, or nullptr for a root.
+	 * @return Node* The new node (valid until reset()).
+	 */
+	Node* create(int move = -1, Node* parent = nullptr) { return create(own, move, parent); }
+
+	/**
+	 * @brief Constructs a node in 'chunk' and appends it to parent->children.
+	 * * The caller must hold parent's lock when other threads may touch it.
+	 */
+	Node* create(Chunk& chunk, int move, Node* parent);
+
+	/**
+	 * @brief Makes room for at least 'capacity' children without further growth.
+	 */
+	void reserveChildren(Node* node, int capacity);
+
+	/**
+	 * @brief Releases every node at once; slabs are kept for the next search.
+	 * * Chunks handed out before are refilled on their next use.
+	 */
+	void reset();
+
+	/**
+	 * @brief Deep-copies a subtree (statistics and structure) into this pool.
+	 * * Used to carry a reused subtree over before the pool it lives in is reset.
+	 * @param src Root of the subtree to copy (may live in another pool).
+	 * @param parent Parent for the copy, or nullptr to make it a root.
+	 * @return Node* The copied subtree root.
+	 */
+	Node* copySubtree(const Node* src, Node* parent = nullptr);
+
+	/**
+	 * @brief Number of nodes created since the last reset().
+	 */
+	int size() const { return node_count.load(std::memory_order_relaxed); }
+
+   private:
+	static constexpr size_t SLAB_BYTES = 1 << 18;  ///< 256 KiB per slab
+
+	/**
+	 * @brief Bump-allocates raw memory from 'chunk', taking a new slab when it is full.
+	 */
+	void* allocate(Chunk& chunk, size_t bytes, size_t align);
+
+	/**
+	 * @brief Gives 'chunk' the next unused slab (locks 'mtx').
+	 */
+	void refill(Chunk& chunk);
+
+	/**
+	 * @brief Moves a node's children into a block of 'capacity' slots carved from 'chunk'.
+	 */
+	void growChildren(Chunk& chunk, Node* node, int capacity);
+
+	std::vector<char*> slabs;		  ///< Every slab ever allocated (freed in the destructor)
+	size_t next_slab = 0;			  ///< First slab not handed to a chunk since reset()
+	unsigned epoch = 0;				  ///< reset() count; older chunks must refill
+	Chunk own;						  ///< Chunk of the single-thread create() overload
+	std::atomic<int> node_count{0};	  ///< Nodes created since reset()
+	std::mutex mtx;					  ///< Serializes refills across search threads
 };
 
 #endif	// NODE_HPP
\ No newline at end of file
@@ -0,0 +1,147 @@
+/**
+ * @file perft.cpp
+ * @brief Move generation check and benchmark: leaf counts to a fixed depth for every backend.
+ * * Run from src/server/ (the position path is relative). 4T_GST.hpp befriends 'int main()',
+ * * so the options come from the environment:
+ * *   PERFT_DEPTH=d             plies below each root (default 4)
+ * *   PERFT_POSITIONS=file      saved positions (default ./data/quant_positions.txt)
+ * *   PERFT_LIMIT=N             first N positions of the file (default 200)
+ * *   PERFT_DETERMINIZATIONS=K  determinizations per root (default 2)
+ * * Walks the full game tree (gen_all_move + do_move + undo on every edge, finished games are
+ * * not expanded) from the standard opening and from the saved positions, once with the
+ * * enemy colors hidden as the server sees them and once over K seeded determinizations of
+ * * each root. Every backend the build has (GST_ARRAY, and GST_BITBOARD in bitboard builds)
+ * * walks the same roots; the leaf counts must agree (exit code 1 otherwise), and each
+ * * backend reports its nodes/s.
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#include "4T_GST.hpp"
+#include "4T_header.h"
+#include "tool_common.hpp"
+
+/// Standard starting squares (see init_board) with A-D red, E-H blue and the enemy hidden
+static const char OPENING[] = "14R24R34R44R15B25B35B45B41u31u21u11u40u30u20u10u";
+
+/// Indexed by GST_ARRAY / GST_BITBOARD
+static const char* BACKEND_NAMES[] = {"array", "bitboard"};
+
+struct PerftCount {
+	uint64_t leaves = 0;  ///< Positions reached at the full depth
+	uint64_t nodes = 0;	  ///< do_move / undo pairs made on the way
+};
+
+/**
+ * @brief Counts the leaves 'depth' plies below 'game' (restored on return).
+ */
+static void perft(GST& game, int backend, int depth, PerftCount& count) {
+	if (depth == 0) {
+		count.leaves++;
+		return;
+	}
+	if (game.is_over()) return;
+
+	int moves[MAX_MOVES];
+	const int n = game.gen_all_move_with(backend, moves);
+	for (int i = 0; i < n; i++) {
+		game.do_move(moves[i]);
+		count.nodes++;
+		perft(game, backend, depth - 1, count);
+		game.undo();
+	}
+}
+
+/**
+ * @brief Gives the hidden enemy pieces seeded colors, like ISMCTS::randomizeUnrevealedPieces.
+ */
+static void determinize(GST& game, std::mt19937& gen) {
+	int hidden[PIECES], n = 0, red = PIECES / 2;
+	for (int i = PIECES; i < PIECES * 2; i++) {
+		if (game.is_revealed(i))
+			red -= game.get_color(i) == -RED;
+		else
+			hidden[n++] = i;
+	}
+	std::shuffle(hidden, hidden + n, gen);
+	for (int i = 0; i < n; i++) game.set_color(hidden[i], i < red ? -RED : -BLUE);
+}
+
+/**
+ * @brief Integer option from the environment, 'fallback' when unset.
+ */
+static int env_int(const char* name, int fallback) {
+	const char* value = getenv(name);
+	return value ? atoi(value) : fallback;
+}
+
+int main() {
+	const char* env_path = getenv("PERFT_POSITIONS");
+	const std::string path = env_path ? env_path : "./data/quant_positions.txt";
+	const int depth = env_int("PERFT_DEPTH", 4);
+	const int limit = env_int("PERFT_LIMIT", 200);
+	const int determinizations = env_int("PERFT_DETERMINIZATIONS", 2);
+	if (!freopen(NULL_DEVICE, "r", stdin)) return 1;  // print_board waits for a key press
+
+	std::vector<std::string> lines = read_positions(path);
+	if (static_cast<int>(lines.size()) > limit) lines.resize(limit);
+	if (lines.empty()) fprintf(stderr, "%s: no positions, opening only\n", path.c_str());
+
+	// 1. Root sets: as the server sees them, then K determinizations of each root
+	std::vector<GST> opening(1), positions(lines.size());
+	load_position(opening[0], OPENING);
+	for (size_t i = 0; i < lines.size(); i++) load_position(positions[i], lines[i]);
+
+	std::mt19937 gen(20260601);
+	auto determinized = [&](const std::vector<GST>& roots) {
+		std::vector<GST> out;
+		for (const GST& root : roots) {
+			for (int k = 0; k < determinizations; k++) {
+				out.push_back(root);
+				determinize(out.back(), gen);
+			}
+		}
+		return out;
+	};
+	struct RootSet {
+		const char* name;
+		std::vector<GST> roots;
+	};
+	std::vector<RootSet> sets = {{"opening", opening},
+								 {"opening, determinized", determinized(opening)},
+								 {"positions", positions},
+								 {"positions, determinized", determinized(positions)}};
+
+	// 2. Every set with every backend
+	printf("Perft to depth %d, GST_BACKEND %s, %zu positions (%s), %d determinizations\n", depth,
+		   BACKEND_NAMES[GST_BACKEND], lines.size(), path.c_str(), determinizations);
+	printf("  %-24s %6s  %-9s %14s %14s %10s\n", "set", "roots", "backend", "leaves", "nodes",
+		   "Mnodes/s");
+	bool match = true;
+	for (RootSet& set : sets) {
+		if (set.roots.empty()) continue;
+		bool first = true;
+		uint64_t expected = 0;
+		for (int backend : {GST_ARRAY, GST_BITBOARD}) {
+			if (!GST::has_backend(backend)) continue;
+			PerftCount count;
+			auto t0 = std::chrono::steady_clock::now();
+			for (GST& root : set.roots) perft(root, backend, depth, count);
+			const double seconds =
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+			printf("  %-24s %6zu  %-9s %14llu %14llu %10.2f\n", set.name, set.roots.size(),
+				   BACKEND_NAMES[backend], static_cast<unsigned long long>(count.leaves),
+				   static_cast<unsigned long long>(count.nodes), count.nodes / seconds / 1e6);
+			if (first) expected = count.leaves;
+			if (count.leaves != expected) {
+				fprintf(stderr, "%s: %s counts %llu leaves, expected %llu\n", set.name,
+						BACKEND_NAMES[backend], static_cast<unsigned long long>(count.leaves),
+						static_cast<unsigned long long>(expected));
+				match = false;
+			}
+			first = false;
+		}
+	}
+	printf("%s\n", match ? "Leaf counts match across backends" : "LEAF COUNT MISMATCH");
+	return match ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file quant_report.cpp
+ * @brief Measures how often the quantized LUTs change highest_weight's choices.
+ * * Run from src/server/ (the weight paths are relative). 4T_GST.hpp befriends 'int main()',
+ * * so the options come from the environment:
+ * *   QUANT_POSITIONS=file  position set (default ./data/quant_positions.txt)
+ * *   QUANT_RECORD=N        self-play N positions into that file first
+ * * The table width is the build's lut_quant_t: 16-bit by default, -DLUT_QUANT_BITS=8 for
+ * * 8-bit. Every position is scored by score_moves with the float and the quantized tables,
+ * * and the report compares the argmax sets and the softmax (T = 1) distributions.
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#include "4T_GST.hpp"
+#include "4T_WEIGHTS.hpp"
+#include "4T_header.h"
+#include "tool_common.hpp"
+
+/**
+ * @brief Server position string (see GST::set_board) of 'game' with the enemy colors hidden.
+ */
+static std::string position_string(const GST& game) {
+	std::string position;
+	for (int i = 0; i < PIECES * 2; i++) {
+		const int p = game.get_pos(i), c = abs(game.get_color(i));
+		if (p < 0) {
+			position += "99";
+			position += c == RED ? 'r' : 'b';
+		} else {
+			position += static_cast<char>('0' + p % COL);
+			position += static_cast<char>('0' + p / COL);
+			position += i < PIECES ? (c == RED ? 'R' : 'B') : 'u';
+		}
+	}
+	return position;
+}
+
+/**
+ * @brief Self-play (greedy on the float tables, 30% random moves) sampling USER-to-move
+ * * positions into 'path'. Move choices come from a fixed seed; the colors from init_board.
+ */
+static bool record_positions(const InferenceWeights& w, int count, const std::string& path) {
+	FILE* out = fopen(path.c_str(), "w");
+	if (!out) return false;
+	std::mt19937 gen(20260601);
+	std::uniform_real_distribution<> prob(0.0, 1.0);
+	int recorded = 0;
+	while (recorded < count) {
+		GST game;
+		game.init_board();
+		for (int ply = 0; ply < 200 && !game.is_over() && recorded < count; ply++) {
+			int moves[MAX_MOVES];
+			const int n = game.gen_all_move(moves);
+			if (n == 0) break;
+			if (ply % 2 == 0 && prob(gen) < 0.25) {
+				fprintf(out, "%s\n", position_string(game).c_str());
+				recorded++;
+			}
+			int move = moves[std::uniform_int_distribution<int>(0, n - 1)(gen)];
+			if (prob(gen) >= 0.3) {
+				float weight[MAX_MOVES];
+				game.score_moves(w, moves, n, weight);
+				move = moves[std::max_element(weight, weight + n) - weight];
+			}
+			game.do_move(move);
+		}
+	}
+	fclose(out);
+	return true;
+}
+
+/**
+ * @brief Softmax (T = 1, as SELECTION_MODE 2) over the candidate scores.
+ */
+static void softmax(const float* weight, int n, double* prob) {
+	const float max_weight = *std::max_element(weight, weight + n);
+	double sum = 0;
+	for (int i = 0; i < n; i++) {
+		prob[i] = std::exp(static_cast<double>(weight[i] - max_weight));
+		sum += prob[i];
+	}
+	for (int i = 0; i < n; i++) prob[i] /= sum;
+}
+
+/**
+ * @brief Candidate picked by inverse-CDF sampling with the uniform draw u.
+ */
+static int sample(const double* prob, int n, double u) {
+	double acc = 0;
+	for (int i = 0; i < n; i++) {
+		acc += prob[i];
+		if (u < acc) return i;
+	}
+	return n - 1;
+}
+
+int main() {
+	const char* env_path = getenv("QUANT_POSITIONS");
+	const char* env_record = getenv("QUANT_RECORD");
+	const std::string path = env_path ? env_path : "./data/quant_positions.txt";
+	const int record = env_record ? atoi(env_record) : 0;
+	if (!freopen(NULL_DEVICE, "r", stdin)) return 1;  // print_board waits for a key press
+
+	static InferenceWeights w;
+	if (!w.read_data_file(500000)) {
+		fprintf(stderr, "standard tables for 500000 not found\n");
+		return 1;
+	}
+	static QuantizedWeights q(w);
+
+	if (record > 0 && !record_positions(w, record, path)) {
+		fprintf(stderr, "%s: cannot write\n", path.c_str());
+		return 1;
+	}
+
+	const std::vector<std::string> positions = read_positions(path);
+	if (positions.empty()) {
+		fprintf(stderr, "%s: no positions\n", path.c_str());
+		return 1;
+	}
+
+	// Softmax choices are compared at the same evenly spaced uniform draws
+	const int DRAWS = 64;
+	long candidates = 0, argmax_differs = 0, argmax_lost = 0, sampled_differs = 0;
+	double tv_sum = 0, tv_max = 0, eval_error_max = 0;
+	double float_ns = 0, quant_ns = 0;
+
+	static GST game;  // Zero-initialized like the server's (set_board keeps n_plies)
+	for (const std::string& line : positions) {
+		load_position(game, line);
+
+		int moves[MAX_MOVES];
+		const int n = game.gen_all_move(moves);
+		if (n == 0) continue;
+		candidates += n;
+
+		// Raw evaluations, timed (each call is repeated to get above timer resolution)
+		float raw_f[MAX_MOVES], raw_q[MAX_MOVES];
+		const int REPEAT = 64;
+		auto t0 = std::chrono::steady_clock::now();
+		for (int r = 0; r < REPEAT; r++) game.evaluate_moves(w, moves, n, raw_f);
+		auto t1 = std::chrono::steady_clock::now();
+		for (int r = 0; r < REPEAT; r++) game.evaluate_moves(q, moves, n, raw_q);
+		auto t2 = std::chrono::steady_clock::now();
+		float_ns += std::chrono::duration<double, std::nano>(t1 - t0).count() / REPEAT;
+		quant_ns += std::chrono::duration<double, std::nano>(t2 - t1).count() / REPEAT;
+		for (int i = 0; i < n; i++)
+			eval_error_max = std::max(eval_error_max, std::fabs(double(raw_f[i]) - raw_q[i]));
+
+		// Policy scores (with the corner / endgame bonuses)
+		float score_f[MAX_MOVES], score_q[MAX_MOVES];
+		game.score_moves(w, moves, n, score_f);
+		game.score_moves(q, moves, n, score_q);
+
+		const float max_f = *std::max_element(score_f, score_f + n);
+		const float max_q = *std::max_element(score_q, score_q + n);
+		bool same_set = true, kept = false;
+		for (int i = 0; i < n; i++) {
+			const bool best_f = score_f[i] == max_f, best_q = score_q[i] == max_q;
+			if (best_f != best_q) same_set = false;
+			if (best_f && best_q) kept = true;
+		}
+		argmax_differs += !same_set;
+		argmax_lost += !kept;
+
+		double prob_f[MAX_MOVES], prob_q[MAX_MOVES];
+		softmax(score_f, n, prob_f);
+		softmax(score_q, n, prob_q);
+		double tv = 0;
+		for (int i = 0; i < n; i++) tv += std::fabs(prob_f[i] - prob_q[i]);
+		tv /= 2;
+		tv_sum += tv;
+		tv_max = std::max(tv_max, tv);
+		for (int k = 0; k < DRAWS; k++) {
+			const double u = (k + 0.5) / DRAWS;
+			sampled_differs += sample(prob_f, n, u) != sample(prob_q, n, u);
+		}
+	}
+
+	const double count = static_cast<double>(positions.size());
+	printf("Quantization report: %d-bit tables, %zu positions (%s), %ld candidates\n",
+		   static_cast<int>(8 * sizeof(lut_quant_t)), positions.size(), path.c_str(), candidates);
+	printf("  max |float - quantized| evaluation : %.3g\n", eval_error_max);
+	printf("  argmax set differs                 : %.2f%% of positions\n",
+		   100.0 * argmax_differs / count);
+	printf("  no float argmax among quantized    : %.2f%% of positions\n",
+		   100.0 * argmax_lost / count);
+	printf("  softmax total variation            : mean %.3g, max %.3g\n", tv_sum / count, tv_max);
+	printf("  softmax sample differs (same draw) : %.3f%% of %d draws per position\n",
+		   100.0 * sampled_differs / (count * DRAWS), DRAWS);
+	printf("  evaluate_moves                     : float %.0f ns, quantized %.0f ns\n",
+		   float_ns / count, quant_ns / count);
+	return 0;
+}
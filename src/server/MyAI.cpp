@@ -12,10 +12,105 @@
 #include "../4T_header.h"
 #include "../ismcts.hpp"
 
+// Worker threads for ISMCTS (override with -DISMCTS_THREADS=N)
+#ifndef ISMCTS_THREADS
+#define ISMCTS_THREADS 1
+#endif
+
+// ISMCTS_TREE_PARALLEL = 1 -> Threads share one tree (virtual loss)
+// ISMCTS_TREE_PARALLEL = 0 -> One tree per thread, root statistics merged (Default)
+#ifndef ISMCTS_TREE_PARALLEL
+#define ISMCTS_TREE_PARALLEL 0
+#endif
+
+// Rollouts per expanded leaf, run on a thread pool (override with -DISMCTS_LEAF_ROLLOUTS=K)
+#ifndef ISMCTS_LEAF_ROLLOUTS
+#define ISMCTS_LEAF_ROLLOUTS 1
+#endif
+
+// ISMCTS_TREE_REUSE = 1 -> Keep the subtree under the moves actually played (Default)
+// ISMCTS_TREE_REUSE = 0 -> Rebuild the tree from scratch on every MOV?
+#ifndef ISMCTS_TREE_REUSE
+#define ISMCTS_TREE_REUSE 1
+#endif
+
+// ISMCTS_PONDER = 1 -> Keep searching while the opponent thinks (needs tree reuse)
+// ISMCTS_PONDER = 0 -> Idle between moves (Default)
+#ifndef ISMCTS_PONDER
+#define ISMCTS_PONDER 0
+#endif
+
+// ISMCTS_TIME_BUDGET = 1 -> Search each move until a deadline derived from the game clock
+// ISMCTS_TIME_BUDGET = 0 -> Fixed number of simulations per move (Default)
+#ifndef ISMCTS_TIME_BUDGET
+#define ISMCTS_TIME_BUDGET 0
+#endif
+
+// Total thinking time per game in milliseconds (override with -DGAME_TIME_MS=T)
+#ifndef GAME_TIME_MS
+#define GAME_TIME_MS 600000
+#endif
+
+// Binary weight file mapped at startup (see weights_convert); the CSVs are parsed only if
+// it is missing or invalid (a LUT_MIRROR build needs a file converted with LUT_MIRROR)
+#ifndef WEIGHT_FILE
+#if LUT_MIRROR
+#define WEIGHT_FILE "./data/weights_500000_mirror.bin"
+#else
+#define WEIGHT_FILE "./data/weights_500000.bin"
+#endif
+#endif
+
+// SHARED_WEIGHTS = 1 -> Attach to a host-wide shared-memory copy of the weights; the first
+//                       process fills it from WEIGHT_FILE (or the CSVs)
+// SHARED_WEIGHTS = 0 -> Every process maps WEIGHT_FILE on its own (Default)
+#ifndef SHARED_WEIGHTS
+#define SHARED_WEIGHTS 0
+#endif
+#ifndef SHARED_WEIGHTS_NAME
+#if LUT_MIRROR
+#define SHARED_WEIGHTS_LAYOUT "_mirror"
+#else
+#define SHARED_WEIGHTS_LAYOUT ""
+#endif
+#ifdef _WIN32
+#define SHARED_WEIGHTS_NAME "Local\\gst_weights_500000_v1" SHARED_WEIGHTS_LAYOUT
+#else
+#define SHARED_WEIGHTS_NAME "/gst_weights_500000_v1" SHARED_WEIGHTS_LAYOUT
+#endif
+#endif
+
+// Simulations per move; only a safety cap when the time budget is enabled
+#ifndef ISMCTS_SIMULATIONS
+#if ISMCTS_TIME_BUDGET
+#define ISMCTS_SIMULATIONS 1000000
+#else
+#define ISMCTS_SIMULATIONS 10000
+#endif
+#endif
+
 // Global instances for AI logic
-DATA data;
+WeightFile weight_file;					   // Memory-mapped weights (preferred)
+const InferenceWeights* weights = nullptr;  // Mapped weights, or the CSV fallback
+const EvalWeights* eval_weights = nullptr;  // What the search reads (see LUT_QUANT_BITS)
 GST game;
-ISMCTS ismcts(10000);  // Initialize ISMCTS with 10,000 simulations
+ISMCTS ismcts(ISMCTS_SIMULATIONS, ISMCTS_THREADS);
+
+#if SHARED_WEIGHTS
+/**
+ * @brief Fills a new shared weight segment from WEIGHT_FILE, or from the CSVs without it.
+ */
+static bool fill_shared_weights(InferenceWeights& w, uint32_t& trained_mask) {
+	WeightFile file;
+	if (file.open(WEIGHT_FILE)) {
+		w = file.weights();
+		trained_mask = file.info().trained_mask;
+		return true;
+	}
+	trained_mask = 1u << TABLE_U | 1u << TABLE_E;
+	return w.read_data_file(500000);
+}
+#endif
 
 // =============================
 // Constructor & Destructor
@@ -23,11 +118,34 @@ ISMCTS ismcts(10000);  // Initialize ISMCTS with 10,000 simulations
 
 /**
  * @brief Construct a new MyAI object.
- * * Initializes N-Tuple data and loads trained weights.
+ * * Loads the trained N-Tuple weights.
  */
 MyAI::MyAI(void) {
-	data.init_data();			  // Initialize N-Tuple structures
-	data.read_data_file(500000);  // Load pre-trained weights
+	// Load pre-trained weights: shared segment (optional), binary file, then CSV
+#if SHARED_WEIGHTS
+	if (weight_file.open_shared(SHARED_WEIGHTS_NAME, fill_shared_weights))
+		weights = &weight_file.weights();
+#endif
+	if (!weights && weight_file.open(WEIGHT_FILE)) weights = &weight_file.weights();
+	if (!weights) {
+		fprintf(stderr, "Falling back to CSV weights\n");
+		static InferenceWeights csv_weights;  // Only constructed (and paged in) on this path
+		csv_weights.read_data_file(500000);
+		weights = &csv_weights;
+	}
+#if LUT_QUANT_BITS
+	static QuantizedWeights quantized(*weights);
+	eval_weights = &quantized;
+#else
+	eval_weights = weights;
+#endif
+
+	ismcts.setParallelMode(ISMCTS_TREE_PARALLEL ? ParallelMode::Tree : ParallelMode::Root);
+	ismcts.setLeafParallel(ISMCTS_LEAF_ROLLOUTS);
+	ismcts.setTreeReuse(ISMCTS_TREE_REUSE);
+
+	time_left_ms = GAME_TIME_MS;
+	moves_made = 0;
 }
 
 MyAI::~MyAI(void) {}
@@ -72,6 +190,13 @@ auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since
  * @param response Buffer to return the selected Red pieces.
  */
 void MyAI::Set(char* response) {
+	// A new game: this object outlives games, so restart the clock, the engine history
+	// and the search (a reused tree would belong to the previous game)
+	time_left_ms = GAME_TIME_MS;
+	moves_made = 0;
+	game.clear_history();
+	ismcts.reset();
+
 	std::mt19937 generator(nanos);
 	std::string pieces = "ABCDEFGH";
 
@@ -96,6 +221,9 @@ void MyAI::Set(char* response) {
  * @param response Buffer to return the calculated move.
  */
 void MyAI::Get(const char* data[], char* response) {
+	auto start = std::chrono::steady_clock::now();
+	ismcts.stopPondering();	 // The opponent has replied; hand the tree back to the search
+
 	// Parse board string from server message
 	char position[49];	// 3 chars per piece * 16 pieces + 1 null terminator
 	position[0] = '\0';
@@ -109,6 +237,11 @@ void MyAI::Get(const char* data[], char* response) {
 
 	// Format response
 	snprintf(response, 50, "MOV:%s", move);
+
+	// Charge the whole turn (parsing included) to our clock
+	auto spent = std::chrono::steady_clock::now() - start;
+	time_left_ms -= std::chrono::duration_cast<std::chrono::milliseconds>(spent).count();
+	moves_made++;
 }
 
 // =============================
@@ -118,7 +251,28 @@ void MyAI::Get(const char* data[], char* response) {
 /**
  * @brief Handles the 'exit' command: Cleanup and log.
  */
-void MyAI::Exit(const char* data[], char* response) { fprintf(stderr, "Bye~\n"); }
+void MyAI::Exit(const char* data[], char* response) {
+	ismcts.stopPondering();
+	fprintf(stderr, "Bye~\n");
+}
+
+// =============================
+// Pondering
+// =============================
+
+/**
+ * @brief Starts background search on the state after our last move.
+ */
+void MyAI::Ponder() {
+#if ISMCTS_PONDER
+	ismcts.startPondering(game, *eval_weights);
+#endif
+}
+
+/**
+ * @brief Stops background search without starting a new one.
+ */
+void MyAI::Stop_pondering() { ismcts.stopPondering(); }
 
 // *********************** AI Internal Logic *********************** //
 
@@ -238,8 +392,17 @@ void MyAI::Print_chessboard() {
  */
 void MyAI::Generate_move(char* move) {
 	// Strategy: Use ISMCTS with N-Tuple heuristic guidance
-	// int best_move = game.highest_weight(data); // Legacy: Pure N-Tuple Greedy
-	int best_move = ismcts.findBestMove(game, data);
+	// int best_move = game.highest_weight(*eval_weights); // Legacy: Pure N-Tuple Greedy
+#if ISMCTS_TIME_BUDGET
+	// Both sides have moved roughly 'moves_made' times each so far
+	int budget_ms = ISMCTS::moveBudgetMs(std::max(0, time_left_ms), moves_made * 2);
+	fprintf(stderr, "Time left: %d ms, budget: %d ms\n", time_left_ms, budget_ms);
+	int best_move =
+		ismcts.findBestMove(game, *eval_weights,
+							std::chrono::steady_clock::now() + std::chrono::milliseconds(budget_ms));
+#else
+	int best_move = ismcts.findBestMove(game, *eval_weights);
+#endif
 
 	int piece = best_move >> 4;
 	int direction = best_move & 0xf;
@@ -10,7 +10,7 @@
 #ifndef MYAI_INCLUDED
 #define MYAI_INCLUDED
 
-#include "../4T_DATA.hpp"
+#include "../4T_WEIGHTS.hpp"
 #include "../4T_header.h"
 
 using std::stoi;
@@ -49,6 +49,12 @@ class MyAI {
 	int piece_pos[PIECES * 2];			///< Position array for all pieces
 	/// @}
 
+	/// @name Time Management
+	/// @{
+	int time_left_ms;  ///< Our remaining game clock, charged with measured think time
+	int moves_made;	   ///< Moves this AI has played so far in the game
+	/// @}
+
 	/// @name Board Operations
 	/// @{
 	/**
@@ -115,6 +121,17 @@ class MyAI {
 	 * @param response Buffer for the response.
 	 */
 	void Exit(const char* data[], char* response);
+
+	/**
+	 * @brief Searches in the background until the next command arrives.
+	 * * Called after a move has been sent; Get() and Exit() stop it.
+	 */
+	void Ponder();
+
+	/**
+	 * @brief Stops background search (e.g. when the game ends).
+	 */
+	void Stop_pondering();
 	/// @}
 };
 
@@ -79,12 +79,15 @@ int main() {
 		} else if (strstr(data[0], "WON") != nullptr) {
 			// Game Won
 			won = true;
+			myai.Stop_pondering();
 		} else if (strstr(data[0], "LST") != nullptr) {
 			// Game Lost
 			lost = true;
+			myai.Stop_pondering();
 		} else if (strstr(data[0], "DRW") != nullptr) {
 			// Game Draw
 			draw = true;
+			myai.Stop_pondering();
 		} else if (strstr(data[0], "OK") != nullptr) {
 			// Acknowledge (No action needed)
 		} else if (strstr(data[0], "SET?") != nullptr) {
@@ -102,6 +105,9 @@ int main() {
 		fflush(stdout);
 		fflush(stderr);
 
+		// Think on the opponent's time once our move is out
+		if (strstr(write, "MOV:") != nullptr) myai.Ponder();
+
 	} while (true);
 
 	return 0;
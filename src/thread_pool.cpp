@@ -0,0 +1,87 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implementation of the fixed-size fork-join thread pool.
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#include "thread_pool.hpp"
+
+// =============================
+// Lifecycle
+// =============================
+
+/**
+ * @brief Spawns the helper threads; they park until the first parallel_for().
+ */
+ThreadPool::ThreadPool(int helpers) {
+	for (int i = 0; i < helpers; i++) workers.emplace_back([this]() { workerLoop(); });
+}
+
+/**
+ * @brief Wakes all helpers with the stop flag set and joins them.
+ */
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lk(mtx);
+		stopping = true;
+	}
+	cv_start.notify_all();
+	for (auto& th : workers) th.join();
+}
+
+// =============================
+// Job Execution
+// =============================
+
+/**
+ * @brief Hands out task indices until none remain.
+ */
+void ThreadPool::drain() {
+	for (int i = next_task.fetch_add(1); i < job_count; i = next_task.fetch_add(1)) (*job)(i);
+}
+
+/**
+ * @brief Publishes a job, runs tasks on the calling thread too, then waits for helpers.
+ */
+void ThreadPool::parallel_for(int count, const std::function<void(int)>& task) {
+	if (workers.empty() || count <= 1) {
+		for (int i = 0; i < count; i++) task(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lk(mtx);
+		job = &task;
+		job_count = count;
+		next_task = 0;
+		busy_workers = static_cast<int>(workers.size());
+		generation++;
+	}
+	cv_start.notify_all();
+
+	drain();
+
+	std::unique_lock<std::mutex> lk(mtx);
+	cv_done.wait(lk, [this]() { return busy_workers == 0; });
+	job = nullptr;
+}
+
+/**
+ * @brief Helper thread main loop.
+ */
+void ThreadPool::workerLoop() {
+	unsigned seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lk(mtx);
+			cv_start.wait(lk, [&]() { return stopping || generation != seen; });
+			if (stopping) return;
+			seen = generation;
+		}
+
+		drain();
+
+		std::lock_guard<std::mutex> lk(mtx);
+		if (--busy_workers == 0) cv_done.notify_one();
+	}
+}
@@ -0,0 +1,70 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Definition of a small fixed-size thread pool for fork-join work.
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "4T_header.h"
+
+/**
+ * @class ThreadPool
+ * @brief Persistent worker threads that execute indexed tasks in parallel.
+ * * Threads are created once and parked between jobs, so a parallel_for() costs a
+ * * wake-up rather than a thread spawn. The calling thread also executes tasks.
+ */
+class ThreadPool {
+   public:
+	/**
+	 * @brief Starts the helper threads.
+	 * @param helpers Number of helper threads (the caller is an additional worker).
+	 */
+	explicit ThreadPool(int helpers);
+
+	/**
+	 * @brief Stops and joins all helper threads.
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * @brief Runs task(0) ... task(count - 1) across the pool and waits for all of them.
+	 * @param count Number of tasks.
+	 * @param task Callable invoked once per task index; must be safe to run concurrently.
+	 */
+	void parallel_for(int count, const std::function<void(int)>& task);
+
+	/**
+	 * @brief Total number of threads that execute tasks (helpers + caller).
+	 */
+	int size() const { return static_cast<int>(workers.size()) + 1; }
+
+   private:
+	/**
+	 * @brief Helper thread body: waits for a job, drains task indices, reports completion.
+	 */
+	void workerLoop();
+
+	/**
+	 * @brief Executes task indices until the current job is exhausted.
+	 */
+	void drain();
+
+	std::vector<std::thread> workers;  ///< Helper threads
+	std::mutex mtx;					   ///< Guards job publication and completion count
+	std::condition_variable cv_start;  ///< Signals helpers that a new job is available
+	std::condition_variable cv_done;   ///< Signals the caller that all helpers finished
+
+	const std::function<void(int)>* job = nullptr;	///< Current job (valid during parallel_for)
+	int job_count = 0;								///< Number of tasks in the current job
+	std::atomic<int> next_task{0};					///< Next task index to hand out
+	int busy_workers = 0;							///< Helpers still working on the current job
+	unsigned generation = 0;						///< Job counter (wakes helpers exactly once)
+	bool stopping = false;							///< Set by the destructor
+};
+
+#endif	// THREAD_POOL_HPP
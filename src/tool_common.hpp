@@ -0,0 +1,71 @@
+/**
+ * @file tool_common.hpp
+ * @brief Helpers shared by the offline tools (quant_report, perft, bench, alloc_check): quiet
+ * * board setup and position files.
+ * * A position file holds one server position string (see GST::set_board) per line, as
+ * * written by quant_report (QUANT_RECORD).
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#ifndef TOOL_COMMON_HPP
+#define TOOL_COMMON_HPP
+
+#include "4T_GST.hpp"
+#include "4T_header.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define NULL_DEVICE "NUL"
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+/**
+ * @brief Silences stdout while alive (set_board prints every board it loads).
+ * * fd 2 silences stderr instead (the search logs its choice there).
+ */
+struct QuietStdout {
+	int fd, saved;
+	explicit QuietStdout(int fd = 1) : fd(fd) {
+		fflush(nullptr);
+		saved = dup(fd);
+		FILE* null = fopen(NULL_DEVICE, "w");
+		if (null) {
+			dup2(fileno(null), fd);
+			fclose(null);
+		}
+	}
+	~QuietStdout() {
+		fflush(nullptr);
+		dup2(saved, fd);
+		close(saved);
+	}
+};
+
+/**
+ * @brief Reads the position strings of 'path' (lines too short to be positions are skipped).
+ */
+inline std::vector<std::string> read_positions(const std::string& path) {
+	std::vector<std::string> positions;
+	std::ifstream in(path);
+	for (std::string line; std::getline(in, line);)
+		if (line.size() >= 3 * PIECES * 2) positions.push_back(line);
+	return positions;
+}
+
+/**
+ * @brief GST::set_board without the board print-out.
+ * * stdin should already be detached (print_board waits for a key press).
+ */
+inline void load_position(GST& game, const std::string& line) {
+	std::vector<char> position(line.begin(), line.end());
+	position.push_back('\0');
+	QuietStdout quiet;
+	game.set_board(position.data());
+}
+
+#endif	// TOOL_COMMON_HPP
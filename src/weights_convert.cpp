@@ -0,0 +1,62 @@
+/**
+ * @file weights_convert.cpp
+ * @brief Converts the CSV weight files into a binary weight file (see WeightFile).
+ * * Run from src/server/ (the CSV paths are relative):
+ * *   weights_convert [num=500000] [--with-endgame] [out=./data/weights_<num>.bin]
+ * * Built with -DLUT_MIRROR=1 it writes the folded layout, to weights_<num>_mirror.bin.
+ * * Without --with-endgame the R1/B1 tables keep the 0.5 default, which is what the server
+ * * has always played with; the flag converts ./data R1 and ./data B1 as well.
+ * @author Chen You-Kai (Optimization & Docs)
+ */
+
+#include "4T_WEIGHTS.hpp"
+#include "4T_header.h"
+
+int main(int argc, char** argv) {
+	int num = 500000;
+	bool with_endgame = false;
+	std::string out;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--with-endgame")
+			with_endgame = true;
+		else if (!arg.empty() && isdigit(static_cast<unsigned char>(arg[0])))
+			num = std::stoi(arg);
+		else
+			out = arg;
+	}
+	if (out.empty())
+		out = "./data/weights_" + std::to_string(num) + (LUT_MIRROR ? "_mirror" : "") + ".bin";
+
+	// 1. Parse the CSVs once
+	static InferenceWeights w;
+	uint32_t trained_mask = 0;
+	if (!w.read_data_file(num)) {
+		fprintf(stderr, "standard tables for %d not found\n", num);
+		return 1;
+	}
+	trained_mask |= 1u << TABLE_U | 1u << TABLE_E;
+	if (with_endgame) {
+		if (w.read_data_file_R1(num)) trained_mask |= 1u << TABLE_U_R1 | 1u << TABLE_E_R1;
+		if (w.read_data_file_B1(num)) trained_mask |= 1u << TABLE_U_B1 | 1u << TABLE_E_B1;
+	}
+
+	// 2. Write, then read back through the loader and compare every table
+	if (!WeightFile::write(out, w, trained_mask)) {
+		fprintf(stderr, "%s: write failed\n", out.c_str());
+		return 1;
+	}
+	WeightFile check;
+	if (!check.open(out)) return 1;
+	for (int t = 0; t < WEIGHT_TABLES; t++) {
+		if (!check.verify(t) || memcmp(check.weights().table(t), w.table(t),
+									   InferenceWeights::TABLE_SIZE * sizeof(float))) {
+			fprintf(stderr, "%s: table %d does not round-trip\n", out.c_str(), t);
+			return 1;
+		}
+	}
+
+	printf("Wrote %s (%zu bytes, trained tables mask 0x%02x)\n", out.c_str(),
+		   sizeof(WeightFileHeader) + sizeof(InferenceWeights), trained_mask);
+	return 0;
+}